@@ -0,0 +1,116 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2023 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Micro-benchmarks for Rational, the number type underlying Moment.
+  Each benchmark is printed as one line of JSON, for collection by
+  scripts/build/run-bench.py.
+*/
+
+#include "rational.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Keep the optimizer from discarding the results.
+static volatile int sink;
+
+template <class F>
+static void
+bench (char const *name, size_t ops_per_call, F f)
+{
+  using Clock = std::chrono::steady_clock;
+
+  // Double the number of calls until a run takes at least 0.2 seconds.
+  size_t calls = 1;
+  double seconds = 0;
+  for (;;)
+    {
+      auto start = Clock::now ();
+      for (size_t i = 0; i < calls; i++)
+        f ();
+      seconds = std::chrono::duration<double> (Clock::now () - start).count ();
+      if (seconds >= 0.2 || calls >= (size_t (1) << 40))
+        break;
+      calls *= 2;
+    }
+
+  double ops = static_cast<double> (calls) * static_cast<double> (ops_per_call);
+  printf ("{\"name\": \"%s\", \"ops\": %.0f, \"seconds\": %.6f, "
+          "\"ns_per_op\": %.3f}\n",
+          name, ops, seconds, seconds * 1e9 / ops);
+  fflush (stdout);
+}
+
+// Durations as they occur in music: mostly powers of two, with some
+// dots and tuplets.
+static std::vector<Rational>
+durations ()
+{
+  std::vector<Rational> result;
+  for (int i = 0; i < 256; i++)
+    {
+      Rational r (1, int64_t (1) << (i % 6));
+      if (i % 7 == 0)
+        r *= Rational (3, 2);
+      if (i % 11 == 0)
+        r *= Rational (2, 3);
+      result.push_back (r);
+    }
+  return result;
+}
+
+int
+main ()
+{
+  std::vector<Rational> const durs = durations ();
+
+  bench ("rational-add", durs.size (), [&durs] () {
+    Rational now;
+    for (auto const &d : durs)
+      now += d;
+    sink = static_cast<int> (now.num ());
+  });
+
+  bench ("rational-compare", durs.size (), [&durs] () {
+    int less = 0;
+    for (size_t i = 1; i < durs.size (); i++)
+      less += durs[i - 1] < durs[i];
+    sink = less;
+  });
+
+  bench ("rational-multiply", durs.size (), [&durs] () {
+    Rational scale (2, 3);
+    Rational total;
+    for (auto const &d : durs)
+      total += d * scale;
+    sink = static_cast<int> (total.den ());
+  });
+
+  bench ("rational-divide", durs.size (), [&durs] () {
+    Rational q (1);
+    for (auto const &d : durs)
+      q = (q / d) * d;
+    sink = static_cast<int> (q.num ());
+  });
+
+  return EXIT_SUCCESS;
+}
@@ -27,6 +27,7 @@ public:
   static std::string form_string (char const *format, ...)
     __attribute__ ((format (printf, 1, 2)));
   static std::string vform_string (char const *format, va_list args);
+  static void append_fixed (std::string *dest, double val, int precision);
   static std::string hex2bin (const std::string &str);
   static std::string to_lower (std::string s);
   static std::string to_upper (std::string s);
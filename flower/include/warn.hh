@@ -22,6 +22,9 @@
 
 #include "std-string.hh"
 
+#include <utility>
+#include <vector>
+
 /* Log-level bitmasks */
 #define LOG_NONE 0
 #define LOG_ERROR 1 << 0
@@ -43,6 +46,8 @@
 
 extern int loglevel;
 extern bool warning_as_error;
+/* Make error () end the process with _Exit, as needed in forked children.  */
+extern bool exit_immediately_on_error;
 
 /* output messages, in decreasing order of importance */
 [[noreturn]] void error (std::string s, const std::string &location
@@ -70,5 +75,30 @@ void set_loglevel (std::string level);
 
 void expect_warning (const std::string &msg);
 void check_expected_warnings ();
+std::vector<std::string> const &get_expected_warnings ();
+
+/* Programming errors as (message, location) pairs.  */
+typedef std::vector<std::pair<std::string, std::string>> Programming_errors;
+
+/*
+  While an instance exists, programming errors raised on the thread that
+  created it are appended to ERRORS instead of being reported.  Reporting
+  uses global state (expected warnings, -dwarning-as-error), so code running
+  on worker threads collects its errors and the main thread reports them
+  later with report_programming_errors.
+*/
+class Programming_error_collector
+{
+  Programming_errors *previous_;
+
+public:
+  explicit Programming_error_collector (Programming_errors *errors);
+  ~Programming_error_collector ();
+  Programming_error_collector (Programming_error_collector const &) = delete;
+  Programming_error_collector &operator= (Programming_error_collector const &)
+    = delete;
+};
+
+void report_programming_errors (Programming_errors const &errors);
 
 #endif /* WARN_HH */
@@ -21,6 +21,7 @@
 
 #include "real.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
@@ -105,6 +106,17 @@ Rational::mod_rat (Rational div) const
 static int64_t
 gcd (int64_t u, int64_t v)
 {
+  /* Musical durations almost always have power-of-two denominators.
+     The gcd with a power of two is the largest power of two dividing
+     the other number, limited by that power. */
+  if (u > 0 && v > 0)
+    {
+      if (!(v & (v - 1)))
+        return std::min (v, u & -u);
+      if (!(u & (u - 1)))
+        return std::min (u, v & -v);
+    }
+
   int64_t result = 0;
   if (u == 0)
     result = v;
@@ -160,6 +172,14 @@ Rational::normalize ()
           sign_ = 0;
           den_ = 1;
         }
+      else if (!(den_ & (den_ - 1)))
+        {
+          // power-of-two denominator: shift out the common factors of two
+          const int shift = std::min (__builtin_ctzll (num_),
+                                      __builtin_ctzll (den_));
+          num_ >>= shift;
+          den_ >>= shift;
+        }
       else
         {
           int64_t g = gcd (num_, den_);
@@ -231,7 +251,10 @@ Rational::operator+= (Rational r)
     *this = r;
   else
     {
-      int64_t lcm = (den_ / gcd (r.den_, den_)) * r.den_;
+      // the lcm of two powers of two is the larger one
+      int64_t lcm = !(den_ & (den_ - 1)) && !(r.den_ & (r.den_ - 1))
+                      ? std::max (den_, r.den_)
+                      : (den_ / gcd (r.den_, den_)) * r.den_;
       int64_t n
         = sign_ * num_ * (lcm / den_) + r.sign_ * r.num_ * (lcm / r.den_);
       int64_t d = lcm;
@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <cassert>
 #include <climits>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <string>
@@ -121,6 +122,59 @@ String_convert::vform_string (char const *format, va_list args)
   return std::string (buffer);
 }
 
+/*
+  Append VAL with PRECISION decimals to DEST, exactly as
+  printf ("%.*f", PRECISION, VAL) would, but without going through
+  the C library for the common case.  The scaled value is rounded in
+  integer arithmetic; values too large for that, and values of which
+  the rounding is too close to a tie to decide this way, are passed on
+  to snprintf.
+*/
+void
+String_convert::append_fixed (std::string *dest, double val, int precision)
+{
+  static const double powers_of_ten[]
+    = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+
+  if (precision < 0 || precision > 9 || !std::isfinite (val))
+    {
+      *dest += form_string ("%.*f", precision, val);
+      return;
+    }
+
+  // Multiplying by a power of ten this small is exact up to half an
+  // ulp, and below 1e9 an ulp is smaller than 2e-7.
+  double scaled = std::fabs (val) * powers_of_ten[precision];
+  double whole = std::floor (scaled);
+  double fraction = scaled - whole;
+  if (scaled >= 1e9 || std::fabs (fraction - 0.5) < 1e-6)
+    {
+      *dest += form_string ("%.*f", precision, val);
+      return;
+    }
+
+  auto digits = static_cast<unsigned long> (whole) + (fraction > 0.5);
+  char buffer[32];
+  char *const end = buffer + sizeof (buffer);
+  char *p = end;
+  for (int i = 0; i < precision; i++)
+    {
+      *--p = static_cast<char> ('0' + digits % 10);
+      digits /= 10;
+    }
+  if (precision > 0)
+    *--p = '.';
+  do
+    {
+      *--p = static_cast<char> ('0' + digits % 10);
+      digits /= 10;
+    }
+  while (digits);
+  if (std::signbit (val))
+    *--p = '-';
+  dest->append (p, end);
+}
+
 std::string
 String_convert::pad_to (const std::string &s, size_t n)
 {
@@ -270,6 +270,43 @@ TEST (Rational_test, addition)
   CHECK (inf + z == inf);
 }
 
+// Power-of-two denominators take a shortcut when normalizing.
+TEST (Rational_test, power_of_two_denominators)
+{
+  const Rational r (12, 8);
+  EQUAL (3, r.num ());
+  EQUAL (2, r.den ());
+
+  const Rational s (-40, 16);
+  EQUAL (-5, s.num ());
+  EQUAL (2, s.den ());
+
+  const Rational t (64, 4);
+  EQUAL (16, t.num ());
+  EQUAL (1, t.den ());
+
+  const Rational u (3, 1024);
+  EQUAL (3, u.num ());
+  EQUAL (1024, u.den ());
+
+  const Rational sum = Rational (3, 8) + Rational (5, 8);
+  EQUAL (1, sum.num ());
+  EQUAL (1, sum.den ());
+
+  const Rational diff = Rational (1, 4) - Rational (3, 32);
+  EQUAL (5, diff.num ());
+  EQUAL (32, diff.den ());
+
+  const Rational product = Rational (3, 4) * Rational (2, 3);
+  EQUAL (1, product.num ());
+  EQUAL (2, product.den ());
+
+  // mixed with other denominators
+  CHECK (Rational (1, 4) + Rational (1, 3) == Rational (7, 12));
+  CHECK (Rational (6, 12) + Rational (1, 2) == Rational (1));
+  CHECK (Rational (3, 16) * Rational (16, 3) == Rational (1));
+}
+
 TEST (Rational_test, multiplication)
 {
   const struct
@@ -42,6 +42,40 @@ TEST (String_convert_test, hex2bin)
   EQUAL (String_convert::hex2bin ("005aa5ff"), "\x00\x5a\xa5\xff"s);
 }
 
+TEST (String_convert_test, append_fixed)
+{
+  std::string s;
+  String_convert::append_fixed (&s, 1.5, 4);
+  s += ' ';
+  String_convert::append_fixed (&s, -0.00001, 4);
+  s += ' ';
+  String_convert::append_fixed (&s, 2.0, 0);
+  EQUAL (s, "1.5000 -0.0000 2"s);
+
+  // Compare with printf, including ties and large values.
+  double const values[] = {0.0,     -0.0,      0.00005,   0.00015,
+                           0.12345, -1.99995,  123.45675, 2.5,
+                           3.5,     1e5 / 3.0, 1e12,      -7.000049999};
+  for (double v : values)
+    for (int precision = 0; precision < 6; precision++)
+      {
+        std::string fixed;
+        String_convert::append_fixed (&fixed, v, precision);
+        EQUAL (fixed, String_convert::form_string ("%.*f", precision, v));
+      }
+
+  // Pseudo-random values with 1/1024 steps, as occur in layout.
+  unsigned state = 1;
+  for (int i = 0; i < 10000; i++)
+    {
+      state = state * 1103515245 + 12345;
+      double v = (static_cast<int> (state >> 8) % 200000 - 100000) / 1024.0;
+      std::string fixed;
+      String_convert::append_fixed (&fixed, v, 4);
+      EQUAL (fixed, String_convert::form_string ("%.4f", v));
+    }
+}
+
 TEST (String_convert_test, percent_encode)
 {
   EQUAL (String_convert::percent_encode ("A+Z=%X"), "A%2bZ%3d%25X"s);
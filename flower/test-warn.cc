@@ -0,0 +1,58 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2023 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "warn.hh"
+
+#include "yaffut.hh"
+
+#include <string>
+
+using namespace std::string_literals;
+
+class Warn_test
+{
+};
+
+TEST (Warn_test, collect_programming_errors)
+{
+  Programming_errors outer;
+  Programming_errors inner;
+  {
+    Programming_error_collector collect_outer (&outer);
+    programming_error ("first", "here");
+    {
+      Programming_error_collector collect_inner (&inner);
+      programming_error ("second");
+    }
+    programming_error ("third");
+  }
+
+  EQUAL (outer.size (), 2u);
+  EQUAL (outer[0].first, "first"s);
+  EQUAL (outer[0].second, "here"s);
+  EQUAL (outer[1].first, "third"s);
+  EQUAL (inner.size (), 1u);
+  EQUAL (inner[0].first, "second"s);
+
+  // Reported errors go through the usual channel, where an expected
+  // warning suppresses them.
+  expect_warning ("second");
+  report_programming_errors (inner);
+  check_expected_warnings ();
+}
@@ -42,6 +42,7 @@
 /* Define the loglevel (default is INFO) */
 int loglevel = LOGLEVEL_INFO;
 bool warning_as_error = false;
+bool exit_immediately_on_error = false;
 
 bool
 is_loglevel (int level)
@@ -122,6 +123,12 @@ check_expected_warnings ()
   expected_warnings.clear ();
 }
 
+std::vector<std::string> const &
+get_expected_warnings ()
+{
+  return expected_warnings;
+}
+
 bool
 is_expected (const std::string &s)
 {
@@ -183,13 +190,45 @@ print_message (int level, const std::string &location, std::string s,
 error (std::string s, const std::string &location)
 {
   print_message (LOG_ERROR, location, _f ("fatal error: %s", s) + "\n");
+  if (exit_immediately_on_error)
+    std::_Exit (1);
   exit (1);
 }
 
+/* Where programming errors of this thread go instead of being reported,
+   if set.  */
+static thread_local Programming_errors *collected_programming_errors
+  = nullptr;
+
+Programming_error_collector::Programming_error_collector (
+  Programming_errors *errors)
+  : previous_ (collected_programming_errors)
+{
+  collected_programming_errors = errors;
+}
+
+Programming_error_collector::~Programming_error_collector ()
+{
+  collected_programming_errors = previous_;
+}
+
+void
+report_programming_errors (Programming_errors const &errors)
+{
+  for (auto const &e : errors)
+    programming_error (e.first, e.second);
+}
+
 /* Display a severe programming error message, but don't exit.  */
 void
 programming_error (const std::string &s, const std::string &location)
 {
+  if (collected_programming_errors)
+    {
+      collected_programming_errors->emplace_back (s, location);
+      return;
+    }
+
   if (is_expected (s))
     print_message (LOG_DEBUG, location,
                    _f ("suppressed programming error: %s", s) + "\n");
@@ -25,6 +25,7 @@
 #include "engraver.hh"
 #include "international.hh"
 #include "item.hh"
+#include "moment.hh"
 #include "pitch.hh"
 #include "protected-scm.hh"
 #include "rhythmic-head.hh"
@@ -64,6 +65,105 @@ Accidental_entry::Accidental_entry ()
   head_ = 0;
 }
 
+/*
+  An entry of autoAccidentals or autoCautionaries.
+
+  The standard rules defined in scm/music-functions.scm carry the
+  procedure property accidental-rule, which describes them; these are
+  evaluated here without calling Scheme.  Other procedures are called,
+  and so are the standard rules whenever localAlterations contains
+  something the native versions do not handle.
+*/
+struct Accidental_rule
+{
+  enum Kind
+  {
+    CONTEXT_NAME,
+    PROCEDURE,
+    // make-accidental-rule, make-accidental-dodecaphonic-rule
+    SIGNATURE,
+    NEO_MODERN,
+    DODECAPHONIC_NO_REPEAT,
+    TEACHING,
+    INVALID,
+  };
+
+  Kind kind_ = INVALID;
+  // the context name or the procedure
+  SCM scm_ = SCM_BOOL_F;
+
+  // For SIGNATURE rules.
+  bool any_octave_ = false;
+  bool forever_ = false;
+  int laziness_ = 0;
+  bool all_naturals_ = false;
+
+  explicit Accidental_rule (SCM rule);
+};
+
+Accidental_rule::Accidental_rule (SCM rule)
+  : scm_ (rule)
+{
+  if (scm_is_symbol (rule))
+    {
+      kind_ = CONTEXT_NAME;
+      return;
+    }
+  if (!ly_is_procedure (rule))
+    return;
+
+  kind_ = PROCEDURE;
+  SCM desc = scm_procedure_property (rule, ly_symbol2scm ("accidental-rule"));
+  if (!scm_is_pair (desc))
+    return;
+
+  SCM type = scm_car (desc);
+  if (scm_is_eq (type, ly_symbol2scm ("signature"))
+      && scm_ilength (desc) == 4)
+    {
+      SCM octaveness = scm_cadr (desc);
+      SCM laziness = scm_caddr (desc);
+      if (!scm_is_eq (octaveness, ly_symbol2scm ("any-octave"))
+          && !scm_is_eq (octaveness, ly_symbol2scm ("same-octave")))
+        return; // let Scheme warn
+      if (scm_is_eq (laziness, SCM_BOOL_T))
+        forever_ = true;
+      else if (is_scm<int> (laziness))
+        laziness_ = from_scm<int> (laziness);
+      else
+        return;
+      kind_ = SIGNATURE;
+      any_octave_ = scm_is_eq (octaveness, ly_symbol2scm ("any-octave"));
+      all_naturals_ = from_scm<bool> (scm_cadddr (desc));
+    }
+  else if (scm_is_eq (type, ly_symbol2scm ("neo-modern")))
+    kind_ = NEO_MODERN;
+  else if (scm_is_eq (type, ly_symbol2scm ("dodecaphonic-no-repeat")))
+    kind_ = DODECAPHONIC_NO_REPEAT;
+  else if (scm_is_eq (type, ly_symbol2scm ("teaching")))
+    kind_ = TEACHING;
+}
+
+/*
+  A parsed rule list, kept until the property holding it changes.
+*/
+class Accidental_rule_list
+{
+public:
+  SCM source_ = SCM_EOL;
+  std::vector<Accidental_rule> rules_;
+
+  void update (SCM rules)
+  {
+    if (scm_is_eq (rules, source_))
+      return;
+    source_ = rules;
+    rules_.clear ();
+    for (; scm_is_pair (rules); rules = scm_cdr (rules))
+      rules_.emplace_back (scm_car (rules));
+  }
+};
+
 class Accidental_engraver : public Engraver
 {
   void update_local_key_signature (SCM new_signature);
@@ -99,6 +199,9 @@ public:
 
   std::vector<Accidental_entry> accidentals_;
   std::vector<Spanner *> ties_;
+
+  Accidental_rule_list accidental_rules_;
+  Accidental_rule_list cautionary_rules_;
   std::vector<Item *> note_columns_;
 };
 
@@ -118,6 +221,8 @@ void
 Accidental_engraver::derived_mark () const
 {
   scm_gc_mark (last_keysig_);
+  scm_gc_mark (accidental_rules_.source_);
+  scm_gc_mark (cautionary_rules_.source_);
 }
 
 void
@@ -163,45 +268,318 @@ struct Accidental_result
   int score () const { return (need_acc ? 1 : 0) + (need_restore ? 1 : 0); }
 };
 
+/*
+  The entries of localAlterations that matter for a pitch, found in one
+  pass.  An entry has the form (NOTENAME . ALTER) for the key
+  signature, or ((OCTAVE . NOTENAME) . ALTER) for a key signature
+  with octave-specific entries, or ((OCTAVE . NOTENAME) . (ALTER
+  . (BARNUM . END-MOM))) for an accidental in the music, where ALTER
+  may be a symbol instead of a number if the alteration was
+  invalidated.
+*/
+struct Alteration_lookup
+{
+  // Values (cdr) of entries; #f if none.
+  SCM same_octave_ = SCM_BOOL_F;
+  SCM other_octave_ = SCM_BOOL_F;
+  SCM notename_ = SCM_BOOL_F;
+  // Whole entries, as found by find-pitch-entry.
+  SCM any_entry_ = SCM_BOOL_F;
+  SCM global_entry_ = SCM_BOOL_F;
+  SCM local_entry_ = SCM_BOOL_F;
+  // Whether all entries have the documented form.
+  bool ok_ = true;
+
+  Alteration_lookup (SCM local, int octave, int notename);
+};
+
+Alteration_lookup::Alteration_lookup (SCM local, int octave, int notename)
+{
+  for (; scm_is_pair (local); local = scm_cdr (local))
+    {
+      SCM entry = scm_car (local);
+      if (!scm_is_pair (entry))
+        {
+          ok_ = false;
+          return;
+        }
+      SCM key = scm_car (entry);
+      bool matches = false;
+      if (scm_is_pair (key))
+        {
+          if (!is_scm<int> (scm_car (key)) || !is_scm<int> (scm_cdr (key)))
+            {
+              ok_ = false;
+              return;
+            }
+          if (from_scm<int> (scm_cdr (key)) != notename)
+            continue;
+          if (scm_is_false (other_octave_))
+            other_octave_ = scm_cdr (entry);
+          if (from_scm<int> (scm_car (key)) != octave)
+            continue;
+          if (scm_is_false (same_octave_))
+            same_octave_ = scm_cdr (entry);
+          matches = true;
+        }
+      else if (is_scm<int> (key))
+        {
+          if (from_scm<int> (key) != notename)
+            continue;
+          if (scm_is_false (notename_))
+            notename_ = scm_cdr (entry);
+          matches = true;
+        }
+      else
+        {
+          ok_ = false;
+          return;
+        }
+
+      if (matches)
+        {
+          bool is_local = scm_is_pair (scm_cdr (entry));
+          if (scm_is_false (any_entry_))
+            any_entry_ = entry;
+          if (is_local && scm_is_false (local_entry_))
+            local_entry_ = entry;
+          if (!is_local && scm_is_false (global_entry_))
+            global_entry_ = entry;
+        }
+    }
+}
+
+// The alteration of an entry value, if it is an exact number.
+static bool
+get_alteration (SCM value, Rational *alteration)
+{
+  if (scm_is_pair (value))
+    value = scm_car (value);
+  if (!is_scm<Rational> (value))
+    return false;
+  *alteration = from_scm<Rational> (value);
+  return true;
+}
+
+// The position (BARNUM . END-MOM) of an entry value, if any.
+static bool
+get_position (SCM value, int *bar_number, SCM *end_mom)
+{
+  if (!scm_is_pair (value) || !scm_is_pair (scm_cdr (value)))
+    return false;
+  SCM position = scm_cdr (value);
+  if (!is_scm<int> (scm_car (position)))
+    return false;
+  *bar_number = from_scm<int> (scm_car (position));
+  *end_mom = scm_cdr (position);
+  return true;
+}
+
+static Rational
+abs_rational (Rational r)
+{
+  return signbit (r) ? -r : r;
+}
+
+/*
+  check-pitch-against-signature.  Return false if Scheme has to decide.
+*/
+static bool
+check_pitch_against_signature (Accidental_rule const &rule, Context *context,
+                               Pitch const &pitch, int bar_number,
+                               Accidental_result *result)
+{
+  int octave = pitch.get_octave ();
+  int notename = pitch.get_notename ();
+  Alteration_lookup found (get_property (context, "localAlterations"), octave,
+                           notename);
+  if (!found.ok_)
+    return false;
+
+  SCM from_key_sig = found.notename_;
+  if (scm_is_false (from_key_sig))
+    {
+      // Key signatures with octave-specific entries.
+      for (SCM s = get_property (context, "keyAlterations"); scm_is_pair (s);
+           s = scm_cdr (s))
+        {
+          SCM key = scm_is_pair (scm_car (s)) ? scm_caar (s) : SCM_BOOL_F;
+          if (scm_is_pair (key) && is_scm<int> (scm_car (key))
+              && is_scm<int> (scm_cdr (key))
+              && from_scm<int> (scm_car (key)) == octave
+              && from_scm<int> (scm_cdr (key)) == notename)
+            {
+              from_key_sig = scm_cdar (s);
+              break;
+            }
+        }
+    }
+
+  auto recent_enough = [&rule, bar_number] (SCM def) {
+    if (scm_is_number (def) || rule.forever_)
+      return true;
+    int def_bar_number;
+    SCM end_mom;
+    return get_position (def, &def_bar_number, &end_mom)
+           && bar_number <= def_bar_number + rule.laziness_;
+  };
+
+  SCM previous = SCM_BOOL_F;
+  if (!rule.any_octave_ && scm_is_true (found.same_octave_)
+      && recent_enough (found.same_octave_))
+    previous = found.same_octave_;
+  else if (rule.any_octave_ && scm_is_true (found.other_octave_)
+           && recent_enough (found.other_octave_))
+    previous = found.other_octave_;
+  else if (scm_is_true (from_key_sig))
+    previous = from_key_sig;
+
+  SCM def = scm_is_pair (previous) ? scm_car (previous) : previous;
+  if (scm_is_symbol (def))
+    {
+      // accidental-invalid?
+      *result = Accidental_result (false, true);
+      return true;
+    }
+
+  Rational prev_alt (0);
+  if (scm_is_true (previous) && !get_alteration (previous, &prev_alt))
+    return false;
+  Rational this_alt = pitch.get_alteration ();
+
+  *result = Accidental_result ();
+  if ((rule.all_naturals_ && scm_is_false (previous)) || this_alt != prev_alt)
+    {
+      result->need_acc = true;
+      if (this_alt && prev_alt && signbit (this_alt) == signbit (prev_alt)
+          && abs_rational (this_alt) < abs_rational (prev_alt))
+        result->need_restore = true;
+    }
+  return true;
+}
+
+/*
+  neo-modern-accidental-rule, dodecaphonic-no-repeat-rule and
+  teaching-accidental-rule.  Return false if Scheme has to decide.
+*/
+static bool
+check_pitch_against_recent_note (Accidental_rule const &rule, Context *context,
+                                 Pitch const &pitch, int bar_number,
+                                 Accidental_result *result)
+{
+  Alteration_lookup found (get_property (context, "localAlterations"),
+                           pitch.get_octave (), pitch.get_notename ());
+  if (!found.ok_)
+    return false;
+
+  SCM entry = rule.kind_ == Accidental_rule::DODECAPHONIC_NO_REPEAT
+                ? found.local_entry_
+                : found.any_entry_;
+  if (scm_is_false (entry))
+    {
+      *result = Accidental_result (
+        false, rule.kind_ == Accidental_rule::DODECAPHONIC_NO_REPEAT);
+      return true;
+    }
+
+  Rational entry_alt;
+  if (!get_alteration (scm_cdr (entry), &entry_alt))
+    {
+      // A tied entry: its alteration does not match any pitch.
+      if (!scm_is_pair (scm_cdr (entry)) || !scm_is_symbol (scm_cadr (entry)))
+        return false;
+      entry_alt = Rational::infinity ();
+    }
+  int entry_bar_number = 0;
+  SCM entry_end_mom = SCM_BOOL_F;
+  bool has_position
+    = get_position (scm_cdr (entry), &entry_bar_number, &entry_end_mom);
+  Moment const *end_mom = unsmob<Moment> (entry_end_mom);
+  if (has_position && !end_mom)
+    return false;
+  bool same_bar = has_position && entry_bar_number == bar_number;
+  Moment now = context->now_mom ();
+  Rational alt = pitch.get_alteration ();
+
+  if (rule.kind_ == Accidental_rule::DODECAPHONIC_NO_REPEAT)
+    {
+      *result = Accidental_result (
+        true, !(same_bar && now <= *end_mom && entry_alt == alt));
+      return true;
+    }
+
+  // The key alteration: neo-modern looks at the key signature entry,
+  // teaching at none (and thus at 0).
+  Rational key_alt (0);
+  if (rule.kind_ == Accidental_rule::NEO_MODERN
+      && scm_is_true (found.global_entry_)
+      && !get_alteration (scm_cdr (found.global_entry_), &key_alt))
+    return false;
+
+  *result = Accidental_result (
+    false, !(alt == key_alt || (same_bar && now == *end_mom)));
+  return true;
+}
+
 static Accidental_result
-check_pitch_against_rules (Pitch const &pitch, Context *origin, SCM rules,
-                           int bar_number)
+check_pitch_against_rules (Pitch const &pitch, Context *origin,
+                           Accidental_rule_list const &rules, int bar_number)
 {
   Accidental_result result;
-  SCM pitch_scm = pitch.smobbed_copy ();
-  SCM barnum_scm = to_scm (bar_number);
+  SCM pitch_scm = SCM_BOOL_F;
 
-  if (scm_is_pair (rules) && !scm_is_symbol (scm_car (rules)))
+  if (!rules.rules_.empty ()
+      && rules.rules_[0].kind_ != Accidental_rule::CONTEXT_NAME)
     warning (_f ("accidental typesetting list must begin with context-name: %s",
-                 ly_scm2string (scm_car (rules)).c_str ()));
+                 ly_scm2string (rules.rules_[0].scm_).c_str ()));
 
-  for (; scm_is_pair (rules) && origin; rules = scm_cdr (rules))
+  for (vsize i = 0; i < rules.rules_.size () && origin; i++)
     {
-      SCM rule = scm_car (rules);
-      if (ly_is_procedure (rule))
+      Accidental_rule const &rule = rules.rules_[i];
+      Accidental_result rule_result;
+      bool native = false;
+      switch (rule.kind_)
         {
-          SCM rule_result_scm
-            = ly_call (rule, origin->self_scm (), pitch_scm, barnum_scm);
-          Accidental_result rule_result (rule_result_scm);
-
-          result.need_acc |= rule_result.need_acc;
-          result.need_restore |= rule_result.need_restore;
+        case Accidental_rule::CONTEXT_NAME:
+          /*
+            Scan parent contexts to find the context.
+          */
+          if (Context *dad = find_context_above (origin, rule.scm_))
+            origin = dad;
+          continue;
+
+        case Accidental_rule::INVALID:
+          warning (_f ("procedure or context-name expected for accidental "
+                       "rule, found %s",
+                       print_scm_val (rule.scm_).c_str ()));
+          continue;
+
+        case Accidental_rule::SIGNATURE:
+          native = check_pitch_against_signature (rule, origin, pitch,
+                                                  bar_number, &rule_result);
+          break;
+
+        case Accidental_rule::NEO_MODERN:
+        case Accidental_rule::DODECAPHONIC_NO_REPEAT:
+        case Accidental_rule::TEACHING:
+          native = check_pitch_against_recent_note (rule, origin, pitch,
+                                                    bar_number, &rule_result);
+          break;
+
+        case Accidental_rule::PROCEDURE:
+          break;
         }
 
-      /*
-        If symbol then it is a context name.  Scan parent contexts to
-        find it.
-      */
-      else if (scm_is_symbol (rule))
+      if (!native)
         {
-          Context *dad = find_context_above (origin, rule);
-          if (dad)
-            origin = dad;
+          if (scm_is_false (pitch_scm))
+            pitch_scm = pitch.smobbed_copy ();
+          rule_result = Accidental_result (ly_call (
+            rule.scm_, origin->self_scm (), pitch_scm, to_scm (bar_number)));
         }
-      else
-        warning (_f (
-          "procedure or context-name expected for accidental rule, found %s",
-          print_scm_val (rule).c_str ()));
+
+      result.need_acc |= rule_result.need_acc;
+      result.need_restore |= rule_result.need_restore;
     }
 
   return result;
@@ -212,8 +590,8 @@ Accidental_engraver::process_acknowledged ()
 {
   if (accidentals_.size () && !accidentals_.back ().done_)
     {
-      SCM accidental_rules = get_property (this, "autoAccidentals");
-      SCM cautionary_rules = get_property (this, "autoCautionaries");
+      accidental_rules_.update (get_property (this, "autoAccidentals"));
+      cautionary_rules_.update (get_property (this, "autoCautionaries"));
       int barnum = measure_number (context ());
 
       for (vsize i = 0; i < accidentals_.size (); i++)
@@ -230,9 +608,9 @@ Accidental_engraver::process_acknowledged ()
             continue;
 
           Accidental_result acc = check_pitch_against_rules (
-            *pitch, origin, accidental_rules, barnum);
+            *pitch, origin, accidental_rules_, barnum);
           Accidental_result caut = check_pitch_against_rules (
-            *pitch, origin, cautionary_rules, barnum);
+            *pitch, origin, cautionary_rules_, barnum);
 
           bool cautionary = from_scm<bool> (get_property (note, "cautionary"));
           if (caut.score () > acc.score ())
@@ -184,6 +184,14 @@ All_font_metrics::find_otf_font (const std::string &name)
   return ret;
 }
 
+bool
+All_font_metrics::has_otf_font (const std::string &name)
+{
+  SCM val;
+  return otf_dict_->try_retrieve (ly_symbol2scm (name), &val)
+         || !search_path_.find (name + ".otf").empty ();
+}
+
 void
 All_font_metrics::font_config_changed ()
 {
@@ -35,6 +35,7 @@ class Arpeggio_engraver : public Engraver
 {
 public:
   TRANSLATOR_DECLARATIONS (Arpeggio_engraver);
+  bool needs_idle_timesteps () const override { return false; }
 
   void acknowledge_stem (Grob_info);
   void acknowledge_rhythmic_head (Grob_info);
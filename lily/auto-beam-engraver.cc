@@ -140,7 +140,7 @@ Auto_beam_engraver::test_moment (Direction dir, Moment test_mom, Rational dur)
 {
   return scm_is_true (ly_call (
     get_property (this, "autoBeamCheck"), context ()->self_scm (), to_scm (dir),
-    test_mom.smobbed_copy (), Moment (dur).smobbed_copy ()));
+    to_scm (test_mom), to_scm (Moment (dur))));
 }
 
 void
@@ -501,21 +501,30 @@ Axis_group_interface::combine_skylines (SCM smob)
   if (y_common != me)
     programming_error ("combining skylines that don't belong to me");
 
-  Skyline_pair ret;
+  Real my_x = me->relative_coordinate (x_common, X_AXIS);
+  // Copies of the element skylines, which must outlive the merge.
+  std::vector<Skyline_pair> skylines;
+  std::vector<Real> raises;
+  std::vector<Real> shifts;
   for (vsize i = 0; i < elements.size (); i++)
     {
       SCM skyp_scm = get_property (elements[i], "vertical-skylines");
       if (is_scm<Skyline_pair> (skyp_scm))
         {
-          Real offset = elements[i]->relative_coordinate (y_common, Y_AXIS);
-          Skyline_pair skyp = from_scm<Skyline_pair> (skyp_scm);
-          skyp.raise (offset);
-          skyp.shift (elements[i]->relative_coordinate (x_common, X_AXIS));
-          ret.merge (skyp);
+          skylines.push_back (from_scm<Skyline_pair> (skyp_scm));
+          raises.push_back (
+            elements[i]->relative_coordinate (y_common, Y_AXIS));
+          shifts.push_back (elements[i]->relative_coordinate (x_common, X_AXIS)
+                            - my_x);
         }
     }
-  ret.shift (-me->relative_coordinate (x_common, X_AXIS));
-  return to_scm (ret);
+
+  Drul_array<std::vector<Placed_skyline>> placed;
+  for (vsize i = 0; i < skylines.size (); i++)
+    for (const auto d : {DOWN, UP})
+      placed[d].push_back ({&skylines[i][d], raises[i], shifts[i]});
+  return to_scm (Skyline_pair (Skyline (placed[DOWN], DOWN),
+                               Skyline (placed[UP], UP)));
 }
 
 struct Grob_with_priority
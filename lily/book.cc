@@ -19,6 +19,7 @@
 
 #include "book.hh"
 
+#include "lily-imports.hh"
 #include "ly-smob-list.hh"
 #include "music.hh"
 #include "output-def.hh"
@@ -30,6 +31,7 @@
 #include "paper-score.hh"
 #include "page-marker.hh"
 #include "ly-module.hh"
+#include "prob.hh"
 
 #include <cstdio>
 
@@ -215,6 +217,18 @@ Book::process_bookparts (Paper_book *output_paper_book, Output_def *paper,
     }
 }
 
+/*
+  Add SYSTEMS, the systems of SCORE typeset elsewhere (a prob of type
+  cached-score), to OUTPUT_PAPER_BOOK.
+*/
+static void
+add_typeset_score (Score *score, Paper_book *output_paper_book, SCM systems)
+{
+  if (ly_is_module (score->get_header ()))
+    output_paper_book->add_score (score->get_header ());
+  output_paper_book->add_score (systems);
+}
+
 /* process one entry of scores_ */
 void
 Book::process_score (SCM score_scm, Paper_book *output_paper_book,
@@ -222,6 +236,20 @@ Book::process_score (SCM score_scm, Paper_book *output_paper_book,
 {
   if (Score *score = unsmob<Score> (score_scm))
     {
+      SCM cache_key = Lily::score_cache_key (
+        score_scm, output_paper_book->paper ()->self_scm (),
+        layout ? layout->self_scm () : SCM_BOOL_F);
+      if (scm_is_string (cache_key))
+        {
+          SCM cached = Lily::score_cache_read (
+            cache_key, output_paper_book->paper ()->self_scm ());
+          if (unsmob<Prob> (cached))
+            {
+              add_typeset_score (score, output_paper_book, cached);
+              return;
+            }
+        }
+
       SCM outputs = score->book_rendering (output_paper_book->paper (), layout);
 
       while (scm_is_pair (outputs))
@@ -248,9 +276,25 @@ Book::process_score (SCM score_scm, Paper_book *output_paper_book,
             }
           else if (Paper_score *pscore = dynamic_cast<Paper_score *> (output))
             {
-              if (ly_is_module (score->get_header ()))
-                output_paper_book->add_score (score->get_header ());
-              output_paper_book->add_score (pscore->self_scm ());
+              if (scm_is_string (cache_key))
+                {
+                  // Typeset the score from the form in which it is
+                  // stored, so that the output does not depend on whether
+                  // it is read from the cache next time.
+                  SCM systems
+                    = scm_vector_to_list (pscore->get_paper_systems ());
+                  add_typeset_score (
+                    score, output_paper_book,
+                    Lily::score_cache_store (
+                      cache_key, systems,
+                      output_paper_book->paper ()->self_scm ()));
+                }
+              else
+                {
+                  if (ly_is_module (score->get_header ()))
+                    output_paper_book->add_score (score->get_header ());
+                  output_paper_book->add_score (pscore->self_scm ());
+                }
             }
 
           outputs = scm_cdr (outputs);
@@ -293,9 +337,18 @@ Book::process (Output_def *default_paper, Output_def *default_layout,
       paper_book->paper ()->normalize ();
       /* Process scores */
       /* Render in order of parsing.  */
-      for (SCM s = scm_reverse (scores_); scm_is_pair (s); s = scm_cdr (s))
+      SCM scores = scm_reverse (scores_);
+      SCM typeset = Lily::typeset_scores_in_workers (
+        scores, paper_book->paper ()->self_scm (),
+        default_layout ? default_layout->self_scm () : SCM_BOOL_F);
+      for (SCM s = scores; scm_is_pair (s);
+           s = scm_cdr (s), typeset = scm_cdr (typeset))
         {
-          process_score (scm_car (s), paper_book, default_layout);
+          if (unsmob<Prob> (scm_car (typeset)))
+            add_typeset_score (unsmob<Score> (scm_car (s)), paper_book,
+                               scm_car (typeset));
+          else
+            process_score (scm_car (s), paper_book, default_layout);
         }
     }
 
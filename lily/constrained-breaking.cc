@@ -24,6 +24,7 @@
 #include "page-layout-problem.hh"
 #include "paper-column.hh"
 #include "paper-score.hh"
+#include "phase-span.hh"
 #include "simple-spacer.hh"
 #include "system.hh"
 #include "warn.hh"
@@ -154,6 +155,7 @@ Constrained_breaking::space_line (vsize i, vsize j)
 void
 Constrained_breaking::resize (vsize systems)
 {
+  Phase_span span ("line-breaking");
   systems_ = systems;
 
   if (pscore_ && systems_ > valid_systems_)
@@ -390,6 +392,7 @@ void
 Constrained_breaking::initialize (
   Paper_score *ps, std::vector<vsize> const &pagebreak_col_indices)
 {
+  Phase_span span ("line-breaking");
   valid_systems_ = systems_ = 0;
   pscore_ = ps;
 
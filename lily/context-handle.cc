@@ -51,8 +51,8 @@ Context_handle::maybe_increment ()
 void
 Context_handle::maybe_decrement ()
 {
-  if (context_)
-    --context_->client_count_;
+  if (context_ && !--context_->client_count_)
+    context_->note_possible_removal ();
 }
 
 void
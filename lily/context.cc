@@ -42,6 +42,18 @@ Context::is_removable () const
          && !dynamic_cast<Global_context const *> (parent_);
 }
 
+/*
+  This context may have become removable: it lost a client or a child,
+  or it was just created.  Global_context only checks for removable
+  contexts after such a change.
+*/
+void
+Context::note_possible_removal ()
+{
+  if (auto *g = dynamic_cast<Global_context *> (find_top_context (this)))
+    g->request_removal_check ();
+}
+
 void
 Context::check_removal ()
 {
@@ -75,6 +87,7 @@ Context::add_context (Context *child)
   child->init_mom_ = now_mom ();
 
   events_below_->register_as_listener (child->events_below_);
+  child->note_possible_removal ();
 }
 
 Context::Context (Context_def *cdef, SCM ops)
@@ -741,6 +754,7 @@ Context::disconnect_from_parent ()
 {
   parent_->events_below_->unregister_as_listener (events_below_);
   parent_->context_list_ = scm_delq_x (self_scm (), parent_->context_list_);
+  parent_->note_possible_removal ();
   parent_ = 0;
 }
 
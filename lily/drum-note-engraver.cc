@@ -41,6 +41,7 @@ class Drum_notes_engraver : public Engraver
 
 public:
   TRANSLATOR_DECLARATIONS (Drum_notes_engraver);
+  bool needs_idle_timesteps () const override { return false; }
 
 protected:
   void process_music ();
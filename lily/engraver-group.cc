@@ -95,6 +95,7 @@ Engraver_group::announce_grob (Grob_info info, Direction dir,
                                Context *reroute_context)
 {
   announce_infos_.push_back (Announce_grob_info (info, dir));
+  active_ = true;
 
   Context *dad_con
     = reroute_context ? reroute_context : context_->get_parent ();
@@ -0,0 +1,217 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2023 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "event-recorder.hh"
+
+#include "context.hh"
+#include "dispatcher.hh"
+#include "global-context.hh"
+#include "listener.hh"
+#include "moment.hh"
+#include "stream-event.hh"
+
+/*
+  The events of a single context.  This needs to be a smob of its own
+  since it is the target of the listener on the context's event
+  source.
+*/
+class Recorded_context : public Smob<Recorded_context>
+{
+public:
+  struct Time_step
+  {
+    SCM moment_;
+    SCM transposition_;
+    std::vector<SCM> events_;
+  };
+
+  Recorded_context (Event_recorder *recorder, Context *context);
+  ~Recorded_context () = default;
+
+  SCM mark_smob () const;
+
+  void record (SCM);
+  void remove (SCM);
+  void flush ();
+  SCM to_scm () const;
+
+private:
+  Event_recorder *const recorder_;
+  Context *const context_;
+  std::vector<Time_step> steps_;
+  std::vector<SCM> pending_;
+};
+
+Recorded_context::Recorded_context (Event_recorder *recorder, Context *context)
+  : recorder_ (recorder),
+    context_ (context)
+{
+  smobify_self ();
+
+  Dispatcher *d = context->event_source ();
+  d->add_listener (GET_LISTENER (this, record), ly_symbol2scm ("StreamEvent"));
+  d->add_listener (GET_LISTENER (this, remove),
+                   ly_symbol2scm ("RemoveContext"));
+}
+
+SCM
+Recorded_context::mark_smob () const
+{
+  for (auto const &step : steps_)
+    {
+      scm_gc_mark (step.moment_);
+      scm_gc_mark (step.transposition_);
+      for (SCM ev : step.events_)
+        scm_gc_mark (ev);
+    }
+  for (SCM ev : pending_)
+    scm_gc_mark (ev);
+  scm_gc_mark (recorder_->self_scm ());
+  return context_->self_scm ();
+}
+
+void
+Recorded_context::record (SCM ev)
+{
+  pending_.push_back (ev);
+}
+
+/* Add a final entry to record the end moment.  */
+void
+Recorded_context::remove (SCM)
+{
+  steps_.push_back ({recorder_->now_mom (), SCM_BOOL_F, {}});
+}
+
+void
+Recorded_context::flush ()
+{
+  if (pending_.empty ())
+    return;
+
+  steps_.push_back ({recorder_->now_mom (),
+                     get_property (context_, "instrumentTransposition"),
+                     {}});
+  steps_.back ().events_.swap (pending_);
+}
+
+SCM
+Recorded_context::to_scm () const
+{
+  SCM steps = SCM_EOL;
+  for (auto const &step : steps_)
+    {
+      SCM events = SCM_EOL;
+      for (vsize i = step.events_.size (); i--;)
+        events = scm_acons (step.events_[i], SCM_BOOL_T, events);
+      steps = scm_acons (scm_cons (step.moment_, step.transposition_), events,
+                         steps);
+    }
+  return scm_cons (ly_string2scm (context_->id_string ()), steps);
+}
+
+const char *const Event_recorder::type_p_name_ = "ly:event-recorder?";
+
+Event_recorder::Event_recorder (Context *global)
+{
+  now_mom_ = SCM_EOL;
+  smobify_self ();
+  now_mom_ = to_scm (Moment ());
+
+  global->events_below ()->add_listener (GET_LISTENER (this, announce_context),
+                                         ly_symbol2scm ("AnnounceNewContext"));
+  Dispatcher *d = global->event_source ();
+  d->add_listener (GET_LISTENER (this, prepare), ly_symbol2scm ("Prepare"));
+  d->add_listener (GET_LISTENER (this, one_time_step),
+                   ly_symbol2scm ("OneTimeStep"));
+}
+
+Event_recorder::~Event_recorder ()
+{
+}
+
+SCM
+Event_recorder::mark_smob () const
+{
+  for (auto *rc : contexts_)
+    scm_gc_mark (rc->self_scm ());
+  return now_mom_;
+}
+
+void
+Event_recorder::announce_context (SCM sev)
+{
+  auto *const ev = unsmob<Stream_event> (sev);
+  auto *const child = unsmob<Context> (get_property (ev, "context"));
+  auto *const rc = new Recorded_context (this, child);
+  contexts_.push_back (rc);
+  rc->unprotect ();
+}
+
+void
+Event_recorder::prepare (SCM sev)
+{
+  auto *const ev = unsmob<Stream_event> (sev);
+  now_mom_ = get_property (ev, "moment");
+}
+
+void
+Event_recorder::one_time_step (SCM)
+{
+  for (auto *rc : contexts_)
+    rc->flush ();
+}
+
+SCM
+Event_recorder::to_scm () const
+{
+  SCM result = SCM_EOL;
+  for (auto *rc : contexts_)
+    result = scm_cons (rc->to_scm (), result);
+  return result;
+}
+
+LY_DEFINE (ly_make_event_recorder, "ly:make-event-recorder", 1, 0, 0,
+           (SCM global),
+           R"(
+Create an event recorder listening to the global context @var{global}.  It
+records the events heard by every context created below @var{global} while
+music is interpreted in it.  Use @code{ly:event-recorder-contents} to retrieve
+the events.
+           )")
+{
+  auto *const g = LY_ASSERT_SMOB (Global_context, global, 1);
+  return (new Event_recorder (g))->unprotect ();
+}
+
+LY_DEFINE (ly_event_recorder_contents, "ly:event-recorder-contents", 1, 0, 0,
+           (SCM recorder),
+           R"(
+Return the events recorded by @var{recorder}.  The result is a list with an
+entry @code{(@var{id} . @var{steps})} for every context, most recently created
+first.  @var{steps} lists the time steps of that context, latest first, in the
+form @code{((@var{moment} . @var{transposition}) . @var{events})}, where
+@var{events} is a list of @code{(@var{event} . #t)} pairs in the order the
+events were heard.  A final step without events and with @var{transposition}
+set to @code{#f} records the moment at which the context was removed.
+           )")
+{
+  auto *const r = LY_ASSERT_SMOB (Event_recorder, recorder, 1);
+  return r->to_scm ();
+}
@@ -34,6 +34,7 @@ class Fingering_engraver : public Engraver
 
 public:
   TRANSLATOR_DECLARATIONS (Fingering_engraver);
+  bool needs_idle_timesteps () const override { return false; }
 
 protected:
   void stop_translation_timestep ();
@@ -22,6 +22,8 @@
 #include "warn.hh"
 #include "stencil.hh"
 #include "modified-font-metric.hh"
+#include "open-type-font.hh"
+#include "pango-font.hh"
 
 LY_DEFINE (ly_font_get_glyph, "ly:font-get-glyph", 2, 0, 0,
            (SCM font, SCM name),
@@ -131,3 +133,28 @@ current @code{output-scale}.
 
   return to_scm (fm->design_size ());
 }
+
+LY_DEFINE (ly_font_reference, "ly:font-reference", 1, 0, 0, (SCM font),
+           R"(
+Return a description of @var{font} from which
+@code{ly:paper-font-from-reference} can find the font again in a later run,
+or @code{#f} if that is not possible.  The description consists of symbols,
+strings and numbers only.
+           )")
+{
+  auto *const fm = LY_ASSERT_SMOB (Font_metric, font, 1);
+
+  if (auto *mfm = dynamic_cast<Modified_font_metric *> (fm))
+    {
+      if (dynamic_cast<Open_type_font *> (mfm->original_font ()))
+        return ly_list (ly_symbol2scm ("scaled"),
+                        scm_car (mfm->original_font ()->description_),
+                        to_scm (mfm->get_magnification ()));
+    }
+  else if (dynamic_cast<Open_type_font *> (fm))
+    return ly_list (ly_symbol2scm ("otf"), scm_car (fm->description_));
+  else if (auto *pf = dynamic_cast<Pango_font *> (fm))
+    return ly_list (ly_symbol2scm ("pango"),
+                    ly_string2scm (pf->description_string ()));
+  return SCM_BOOL_F;
+}
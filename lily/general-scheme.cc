@@ -31,7 +31,9 @@
 #include "memory.hh"
 #include "misc.hh"
 #include "program-option.hh"
+#include "protected-scm.hh"
 #include "relocate.hh"
+#include "source-file.hh"
 #include "std-vector.hh"
 #include "string-convert.hh"
 #include "version.hh"
@@ -106,6 +108,24 @@ cannot be deleted.
   return SCM_UNSPECIFIED;
 }
 
+LY_DEFINE (ly_file_digest, "ly:file-digest", 1, 0, 0, (SCM file_name),
+           R"(
+Return the SHA-256 checksum of the contents of @var{file-name} as a string of
+hexadecimal digits, or @code{#f} if the file cannot be read or is empty.
+           )")
+{
+  LY_ASSERT_TYPE (scm_is_string, file_name, 1);
+
+  std::string contents = gulp_file (ly_scm2string (file_name), 0);
+  if (contents.empty ())
+    return SCM_BOOL_F;
+
+  unique_glib_ptr<char> digest (g_compute_checksum_for_data (
+    G_CHECKSUM_SHA256, reinterpret_cast<const guchar *> (contents.data ()),
+    contents.size ()));
+  return ly_string2scm (digest.get ());
+}
+
 LY_DEFINE (ly_randomize_rand_seed, "ly:randomize-rand-seed", 0, 0, 0, (),
            R"(
 Randomize C random generator.
@@ -299,6 +319,30 @@ prefix is @file{/foo/bar}.
   return ly_string2scm (lilypond_datadir);
 }
 
+/*
+  Alist watched by ly:chain-assoc-get, and the keys that have been
+  successfully looked up in it.  Page headers and footers use this to
+  find out which page-dependent properties a markup actually reads.
+*/
+static Protected_scm chain_assoc_watched_alist (SCM_BOOL_F);
+static Protected_scm chain_assoc_watched_keys (SCM_EOL);
+
+LY_DEFINE (ly_chain_assoc_watch, "ly:chain-assoc-watch", 2, 0, 0,
+           (SCM alist, SCM keys),
+           R"(
+Record successful lookups by @code{ly:chain-assoc-get} of keys in
+@var{alist}, which must be an element of the alist chain being searched.
+@var{keys} is the initial list of recorded keys.  Use @code{#f} for
+@var{alist} to stop recording.  Return the list of keys recorded up to
+this call.
+           )")
+{
+  SCM recorded = static_cast<SCM> (chain_assoc_watched_keys);
+  chain_assoc_watched_alist = alist;
+  chain_assoc_watched_keys = keys;
+  return recorded;
+}
+
 LY_DEFINE (ly_chain_assoc_get, "ly:chain-assoc-get", 2, 2, 0,
            (SCM key, SCM achain, SCM default_value, SCM strict_checking),
            R"(
@@ -313,7 +357,13 @@ output in such cases.
       SCM handle = scm_is_symbol (key) ? scm_assq (key, scm_car (achain))
                                        : ly_assoc (key, scm_car (achain));
       if (scm_is_pair (handle))
-        return scm_cdr (handle);
+        {
+          if (scm_is_eq (scm_car (achain),
+                         static_cast<SCM> (chain_assoc_watched_alist)))
+            chain_assoc_watched_keys
+              = scm_cons (key, chain_assoc_watched_keys);
+          return scm_cdr (handle);
+        }
       else
         return ly_chain_assoc_get (key, scm_cdr (achain), default_value);
     }
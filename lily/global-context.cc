@@ -28,6 +28,7 @@
 #include "music-iterator.hh"
 #include "music.hh"
 #include "output-def.hh"
+#include "phase-span.hh"
 #include "warn.hh"
 
 #include <cstdio>
@@ -130,6 +131,7 @@ Global_context::get_output ()
 bool
 Global_context::iterate (Music *music, bool force_found_music)
 {
+  Phase_span span ("iteration");
   Cpu_timer timer;
 
   SCM protected_iter = Music_iterator::create_top_iterator (music);
@@ -182,7 +184,7 @@ Global_context::iterate (Music *music, bool force_found_music)
             }
 
           send_stream_event (this, "Prepare", 0, ly_symbol2scm ("moment"),
-                             w.smobbed_copy ());
+                             to_scm (w));
 
           if (first)
             iter->init_context (this);
@@ -192,7 +194,13 @@ Global_context::iterate (Music *music, bool force_found_music)
 
           send_stream_event (this, "OneTimeStep", 0);
           apply_finalizations ();
-          check_removal ();
+          // Walking the context tree every time step is expensive for
+          // large scores, and most steps do not end any context.
+          if (removal_check_pending_)
+            {
+              removal_check_pending_ = false;
+              check_removal ();
+            }
         }
 
       iter->quit ();
@@ -209,6 +217,8 @@ void
 Global_context::apply_finalizations ()
 {
   SCM lst = get_property (this, "finalizations");
+  if (scm_is_null (lst))
+    return;
   set_property (this, "finalizations", SCM_EOL);
   for (SCM s = lst; scm_is_pair (s); s = scm_cdr (s))
     scm_apply_0 (scm_caar (s), scm_cdar (s));
@@ -262,7 +262,11 @@ Grob::try_callback_on_alist (SCM *alist, SCM sym, SCM proc)
     grob_property_callback_stack = scm_cons (ly_list (self_scm (), sym, proc),
                                              grob_property_callback_stack);
 
-  SCM value = ly_call (proc, self_scm ());
+  SCM value;
+  {
+    Callback_profile_frame frame (this, sym, proc);
+    value = ly_call (proc, self_scm ());
+  }
 
   if (debug_property_callbacks)
     grob_property_callback_stack = scm_cdr (grob_property_callback_stack);
@@ -30,6 +30,7 @@
 #include "output-def.hh"
 #include "pointer-group-interface.hh"
 #include "program-option.hh"
+#include "protected-scm.hh"
 #include "skyline-pair.hh"
 #include "stencil.hh"
 #include "stream-event.hh"
@@ -42,6 +43,74 @@
 #include <set>
 #include <unordered_set>
 
+/*
+  Everything Grob::Grob derives from the basic properties alone: the
+  interfaces, the object callbacks and the default extent and skyline
+  callbacks, as a list (INTERFACES OBJECT-ALIST PROPERTY-ALIST).
+
+  Engravers hand out the same cooked property alist for all grobs of
+  one definition until its properties are overridden, so the result is
+  cached per (eq) alist.  The callback containers in PROPERTY-ALIST are
+  shared between all grobs; they are immutable.
+*/
+static SCM
+grob_prototype (SCM basicprops)
+{
+  static Protected_scm prototypes;
+  if (!prototypes.is_bound ())
+    prototypes = scm_make_weak_key_hash_table (to_scm (59));
+
+  SCM proto = scm_hashq_ref (prototypes, basicprops, SCM_BOOL_F);
+  if (scm_is_true (proto))
+    return proto;
+
+  SCM interfaces = SCM_EOL;
+  SCM object_alist = SCM_EOL;
+  SCM meta = ly_assoc_get (ly_symbol2scm ("meta"), basicprops, SCM_EOL);
+  if (scm_is_pair (meta))
+    {
+      interfaces = scm_cdr (scm_assq (ly_symbol2scm ("interfaces"), meta));
+
+      SCM object_cbs = scm_assq (ly_symbol2scm ("object-callbacks"), meta);
+      if (scm_is_pair (object_cbs))
+        {
+          for (SCM s = scm_cdr (object_cbs); scm_is_pair (s); s = scm_cdr (s))
+            object_alist
+              = scm_assq_set_x (object_alist, scm_caar (s), scm_cdar (s));
+        }
+    }
+
+  static Protected_scm stencil_height;
+  static Protected_scm vertical_skylines;
+  static Protected_scm horizontal_skylines;
+  if (!stencil_height.is_bound ())
+    {
+      stencil_height = Unpure_pure_container::make_smob (
+        Grob::stencil_height_proc, Grob::pure_stencil_height_proc);
+      vertical_skylines = Unpure_pure_container::make_smob (
+        Grob::simple_vertical_skylines_from_extents_proc,
+        Grob::pure_simple_vertical_skylines_from_extents_proc);
+      horizontal_skylines = Unpure_pure_container::make_smob (
+        Grob::simple_horizontal_skylines_from_extents_proc,
+        Grob::pure_simple_horizontal_skylines_from_extents_proc);
+    }
+
+  SCM defaults[][2] = {
+    {ly_symbol2scm ("X-extent"), Grob::stencil_width_proc},
+    {ly_symbol2scm ("Y-extent"), stencil_height},
+    {ly_symbol2scm ("vertical-skylines"), vertical_skylines},
+    {ly_symbol2scm ("horizontal-skylines"), horizontal_skylines},
+  };
+  SCM property_alist = SCM_EOL;
+  for (auto const &entry : defaults)
+    if (scm_is_null (ly_assoc_get (entry[0], basicprops, SCM_EOL)))
+      property_alist = scm_acons (entry[0], entry[1], property_alist);
+
+  proto = ly_list (interfaces, object_alist, property_alist);
+  scm_hashq_set_x (prototypes, basicprops, proto);
+  return proto;
+}
+
 Grob::Grob (SCM basicprops)
 {
 
@@ -59,35 +128,12 @@ Grob::Grob (SCM basicprops)
      GC. After smobify_self (), they are.  */
   smobify_self ();
 
-  SCM meta = get_property (this, "meta");
-  if (scm_is_pair (meta))
-    {
-      interfaces_ = scm_cdr (scm_assq (ly_symbol2scm ("interfaces"), meta));
-
-      SCM object_cbs = scm_assq (ly_symbol2scm ("object-callbacks"), meta);
-      if (scm_is_pair (object_cbs))
-        {
-          for (SCM s = scm_cdr (object_cbs); scm_is_pair (s); s = scm_cdr (s))
-            set_object (this, scm_caar (s), scm_cdar (s));
-        }
-    }
-
-  if (scm_is_null (get_property_data (this, "X-extent")))
-    set_property (this, "X-extent", Grob::stencil_width_proc);
-  if (scm_is_null (get_property_data (this, "Y-extent")))
-    set_property (this, "Y-extent",
-                  Unpure_pure_container::make_smob (
-                    Grob::stencil_height_proc, Grob::pure_stencil_height_proc));
-  if (scm_is_null (get_property_data (this, "vertical-skylines")))
-    set_property (this, "vertical-skylines",
-                  Unpure_pure_container::make_smob (
-                    Grob::simple_vertical_skylines_from_extents_proc,
-                    Grob::pure_simple_vertical_skylines_from_extents_proc));
-  if (scm_is_null (get_property_data (this, "horizontal-skylines")))
-    set_property (this, "horizontal-skylines",
-                  Unpure_pure_container::make_smob (
-                    Grob::simple_horizontal_skylines_from_extents_proc,
-                    Grob::pure_simple_horizontal_skylines_from_extents_proc));
+  /* The alists are modified in place later on, so they are copied
+     from the prototype rather than shared.  */
+  SCM proto = grob_prototype (basicprops);
+  interfaces_ = scm_car (proto);
+  object_alist_ = ly_alist_copy (scm_cadr (proto));
+  mutable_property_alist_ = ly_alist_copy (scm_caddr (proto));
 }
 
 Grob::Grob (Grob const &s)
@@ -24,6 +24,7 @@
 #include "file-name.hh"
 #include "file-path.hh"
 #include "international.hh"
+#include "profile.hh"
 #include "source-file.hh"
 #include "sources.hh"
 #include "warn.hh"
@@ -82,6 +83,7 @@ Includable_lexer::new_input (const std::string &name, Source_file *file)
 
   char_count_stack_.push_back (0);
   include_stack_.push_back (file);
+  startup_profile_stack_.push_back (startup_profile_enter ("include", name));
 
   yypush_buffer_state (yy_create_buffer (file->get_istream (), YY_BUF_SIZE));
 }
@@ -94,6 +96,8 @@ Includable_lexer::close_input ()
 {
   include_stack_.pop_back ();
   char_count_stack_.pop_back ();
+  startup_profile_leave (startup_profile_stack_.back ());
+  startup_profile_stack_.pop_back ();
   debug_output ("]", false);
   yypop_buffer_state ();
 }
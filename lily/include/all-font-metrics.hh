@@ -66,6 +66,8 @@ public:
                                bool is_emmentaler, Real scale);
 
   Open_type_font *find_otf_font (const std::string &name);
+  // Whether find_otf_font can find font NAME.
+  bool has_otf_font (const std::string &name);
   SCM font_descriptions () const;
 
   void display_fonts ();
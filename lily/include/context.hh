@@ -184,6 +184,7 @@ public:
   void change_parent (SCM);
   void disconnect_from_parent ();
   void check_removal ();
+  void note_possible_removal ();
   std::string context_name () const;
   SCM context_name_symbol () const;
 
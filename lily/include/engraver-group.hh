@@ -61,6 +61,12 @@ public:
                               Context *reroute_context = 0);
   bool pending_grobs () const;
 
+protected:
+  bool has_announcements () const override
+  {
+    return !announce_infos_.empty ();
+  }
+
 private:
   virtual void acknowledge_grobs ();
 };
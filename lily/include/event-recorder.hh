@@ -0,0 +1,70 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2023 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef EVENT_RECORDER_HH
+#define EVENT_RECORDER_HH
+
+#include "smobs.hh"
+
+#include <vector>
+
+class Recorded_context;
+
+/*
+  Record the events heard by all contexts created below a global
+  context, grouped per context and per moment.  This is the C++
+  counterpart of the Recording_group_engraver of LilyPond 2.8 and
+  earlier; it is used for the analysis passes of \partCombine,
+  \autoChange and \addQuote.
+
+  Events are kept in plain vectors while interpreting and only
+  converted into the list format expected by the Scheme side when
+  requested with to_scm ().
+*/
+class Event_recorder : public Smob<Event_recorder>
+{
+public:
+  static const char *const type_p_name_;
+
+  explicit Event_recorder (Context *global);
+  ~Event_recorder ();
+
+  SCM mark_smob () const;
+  SCM now_mom () const { return now_mom_; }
+
+  /*
+    Return a list with an entry (ID . MOMENTS) for every context
+    created, most recent first.  MOMENTS lists the time steps of the
+    context, most recent first, as ((MOMENT . TRANSPOSITION) . EVENTS);
+    EVENTS is a list of (EVENT . #t) in the order heard.  A final entry
+    with TRANSPOSITION #f and no events marks the removal of the
+    context.
+  */
+  SCM to_scm () const;
+
+private:
+  SCM now_mom_;
+  std::vector<Recorded_context *> contexts_;
+
+  void announce_context (SCM);
+  void prepare (SCM);
+  void one_time_step (SCM);
+};
+
+#endif /* EVENT_RECORDER_HH */
@@ -48,6 +48,7 @@ public:
 
   void apply_finalizations ();
   void add_finalization (SCM);
+  void request_removal_check () { removal_check_pending_ = true; }
 
   void prepare (SCM);
   virtual SCM get_output ();
@@ -62,6 +63,8 @@ private:
 private:
   Moment prev_mom_;
   Moment now_mom_;
+  // Whether a context may have become removable since the last check.
+  bool removal_check_pending_ = true;
 };
 
 // If the given context is null, return null.  Otherwise, starting from the
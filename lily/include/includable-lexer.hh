@@ -38,6 +38,8 @@ protected:
   void close_input ();
   std::vector<Source_file *> include_stack_;
   std::vector<size_t> char_count_stack_;
+  // Startup profile items of the files in include_stack_.
+  std::vector<vsize> startup_profile_stack_;
 
 public:
   Includable_lexer () = default;
@@ -120,6 +120,7 @@ extern Variable default_global_scale;
 extern Variable default_time_signature_settings;
 extern Variable define_markup_command_internal;
 extern Variable feta_design_size_mapping;
+extern Variable font_name_style;
 extern Variable generate_crop_stencil;
 extern Variable generate_preview_stencil;
 extern Variable generate_system_stencils;
@@ -155,6 +156,7 @@ extern Variable markup_list_function_p;
 extern Variable markup_list_p;
 extern Variable markup_to_string;
 extern Variable midi_program;
+extern Variable modified_font_metric_font_scaling;
 extern Variable f_parser;
 extern Variable output_scopes;
 extern Variable percussion_p;
@@ -166,6 +168,9 @@ extern Variable scale_p;
 extern Variable scale_to_factor;
 extern Variable scale_layout;
 extern Variable scm_to_string;
+extern Variable score_cache_key;
+extern Variable score_cache_read;
+extern Variable score_cache_store;
 extern Variable score_lines_markup_list;
 extern Variable score_markup;
 extern Variable scorify_music;
@@ -174,6 +179,7 @@ extern Variable stencil_whiteout_box;
 extern Variable stencil_with_color;
 extern Variable symbol_list_p;
 extern Variable type_name;
+extern Variable typeset_scores_in_workers;
 extern Variable unbroken_or_first_broken_spanner_p;
 extern Variable unbroken_or_last_broken_spanner_p;
 extern Variable volta_bracket_calc_hook_visibility;
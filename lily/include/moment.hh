@@ -95,6 +95,11 @@ public:
 
   std::string to_string () const;
   static int compare (Moment const &, Moment const &);
+
+  // A smob with this value, shared with recent conversions of the same
+  // value.  Use this rather than smobbed_copy () for moments converted
+  // over and over, like the current time and music lengths.
+  SCM interned_smob () const;
 };
 
 int compare (Moment const &, Moment const &);
@@ -113,7 +118,7 @@ template <>
 inline SCM
 to_scm<Moment> (Moment const &m)
 {
-  return m.smobbed_copy ();
+  return m.interned_smob ();
 }
 
 bool moment_less (SCM a, SCM b);
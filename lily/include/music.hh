@@ -62,6 +62,10 @@ public:
 
   DECLARE_SCHEME_CALLBACK (duration_length_callback, (SCM));
 
+private:
+  // The length as a Moment smob, or anything else if there is none.
+  SCM length_scm () const;
+
 protected:
   SCM copy_mutable_properties () const override;
   void type_check_assignment (SCM, SCM) const override;
@@ -73,6 +77,9 @@ protected:
 
 Music *make_music_by_name (SCM sym);
 SCM music_deep_copy (SCM m);
+// Share the entries of property alists that contain no music between
+// copies, copying them only before a change.
+extern bool music_copy_on_write;
 void set_origin (SCM m, SCM origin);
 
 SCM ly_camel_case_2_lisp_identifier (SCM name_sym);
@@ -31,6 +31,8 @@ Font_metric *find_pango_font (Output_def *layout,
                               bool is_emmentaler);
 Font_metric *find_scaled_font (Output_def *od, Font_metric *f,
                                Real magnification);
+Font_metric *find_unscaled_font (Output_def *od, Font_metric *f,
+                                 Real lookup_magnification);
 Output_def *scale_output_def (Output_def *def, Real scale);
 
 Real output_scale (Output_def *);
@@ -0,0 +1,93 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2023 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PHASE_SPAN_HH
+#define PHASE_SPAN_HH
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/*
+  Timing of the main phases of a compilation (parsing, iteration, line
+  and page breaking, ...).  Put a Phase_span on the stack for the
+  duration of a phase:
+
+    Phase_span span ("line-breaking");
+
+  If the trace-file option is set, the span is recorded and all spans
+  are written to that file when LilyPond exits: as Chrome trace-event
+  JSON if the file name ends in `.json', as a per-phase summary
+  otherwise.  With --loglevel=DEBUG, the time, the memory allocated and
+  the garbage collections of every span are printed when it ends.  If
+  the gc-phase-reserve option is set, the heap is grown at the start of
+  a span so that it has at least that much free memory.  If none of
+  these apply, a span costs a few tests.
+
+  The phase name must be a string literal.
+*/
+class Phase_span
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // Cumulative garbage collector statistics.
+  struct Gc_counters
+  {
+    size_t allocated_ = 0;
+    size_t collections_ = 0;
+    double seconds_ = 0;
+
+    static Gc_counters now ();
+  };
+
+  explicit Phase_span (char const *name)
+    : name_ (name)
+  {
+    if (phase_tracing_ || gc_reserve_ || is_debugging ())
+      start ();
+  }
+  ~Phase_span ()
+  {
+    if (started_)
+      stop ();
+  }
+  Phase_span (Phase_span const &) = delete;
+  Phase_span &operator= (Phase_span const &) = delete;
+
+  // Set by the trace-file program option.
+  static void set_trace_file (std::string const &);
+  // Set by the gc-phase-reserve program option.
+  static void set_gc_reserve (size_t bytes) { gc_reserve_ = bytes; }
+
+private:
+  static bool phase_tracing_;
+  static size_t gc_reserve_;
+  static bool is_debugging ();
+
+  void start ();
+  void stop ();
+
+  char const *const name_;
+  bool started_ = false;
+  Clock::time_point start_;
+  Gc_counters gc_start_;
+};
+
+#endif /* PHASE_SPAN_HH */
@@ -46,11 +46,29 @@ private:
 
   void init_vars ();
 
+  /*
+    For the properties looked up most often (see hot_property_slot ()),
+    the handle found in the alists: the pair in mutable_property_alist_
+    or immutable_property_alist_, SCM_BOOL_F if the property is not
+    set, or SCM_UNDEFINED if not looked up yet.  Reset whenever the
+    alists change other than by setting the cdr of an entry.
+  */
+  static constexpr size_t HOT_PROPERTY_COUNT = 8;
+  mutable SCM hot_property_handles_[HOT_PROPERTY_COUNT];
+
+  static size_t hot_property_slot (SCM sym);
+  SCM property_handle (SCM sym) const;
+
 protected:
   SCM mutable_property_alist_;
   SCM immutable_property_alist_;
   SCM type_;
+  // Whether the entries of mutable_property_alist_ may be shared with
+  // a copy, so that they must be copied before changing them.
+  mutable bool mutable_properties_shared_ = false;
 
+  void unshare_mutable_properties ();
+  void forget_hot_properties ();
   virtual void derived_mark () const;
   virtual SCM copy_mutable_properties () const;
   virtual void type_check_assignment (SCM, SCM) const;
@@ -22,6 +22,10 @@
 
 #include "lily-guile.hh"
 
+#include <chrono>
+#include <string>
+
+class Grob;
 class Protected_scm;
 
 void note_property_access (Protected_scm *table, SCM sym);
@@ -30,4 +34,59 @@ extern Protected_scm grob_property_lookup_table;
 extern Protected_scm prob_property_lookup_table;
 extern bool profile_property_accesses;
 
+void set_callback_profiling (bool);
+extern bool profile_callbacks;
+
+/*
+  Startup profiling, set by the startup-profile program option: the
+  time taken by loading every Scheme file and reading every init file
+  before the first input file.  An item is opened with
+
+    vsize item = startup_profile_enter ("include", file_name);
+
+  and closed with startup_profile_leave (item); items opened in
+  between are nested in it.
+*/
+extern bool profile_startup;
+vsize startup_profile_enter (std::string const &kind, std::string const &name);
+void startup_profile_leave (vsize item);
+
+/*
+  Time a grob property callback while the profile-callbacks option is
+  set.  Put one on the stack around the call:
+
+    Callback_profile_frame frame (grob, sym, proc);
+
+  Calls are accumulated per (grob name, property, procedure).  The
+  time spent in callbacks triggered from within this one is subtracted
+  from its exclusive time.
+*/
+class Callback_profile_frame
+{
+public:
+  Callback_profile_frame (Grob *grob, SCM sym, SCM proc)
+  {
+    if (profile_callbacks)
+      start (grob, sym, proc);
+  }
+  ~Callback_profile_frame ()
+  {
+    if (active_)
+      stop ();
+  }
+  Callback_profile_frame (Callback_profile_frame const &) = delete;
+  Callback_profile_frame &operator= (Callback_profile_frame const &) = delete;
+
+private:
+  void start (Grob *, SCM, SCM);
+  void stop ();
+
+  bool active_ = false;
+  SCM grob_name_;
+  SCM sym_;
+  SCM proc_;
+  vsize depth_;
+  std::chrono::steady_clock::time_point start_;
+};
+
 #endif /* PROFILE_HH */
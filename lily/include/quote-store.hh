@@ -0,0 +1,81 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2023 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef QUOTE_STORE_HH
+#define QUOTE_STORE_HH
+
+#include "moment.hh"
+#include "pitch.hh"
+#include "smobs.hh"
+
+#include <utility>
+#include <vector>
+
+/*
+  The events of a quoted voice, as registered with \addQuote, in
+  chronological order.  Quote_iterator looks up the entries of a time
+  range by binary search on the unboxed moments.
+
+  Transposed copies of the events are made once per transposition
+  interval and kept with the store, so that all quotes of the same
+  music at the same transposition share them.
+*/
+class Quote_store : public Smob<Quote_store>
+{
+public:
+  static const char *const type_p_name_;
+
+  struct Entry
+  {
+    Moment when_;
+    // The instrumentTransposition of the quoted voice, if set.
+    Pitch transposition_;
+    bool has_transposition_;
+    // The events heard at this moment.
+    SCM events_;
+  };
+
+  /*
+    ENTRIES is a list of ((MOMENT . TRANSPOSITION) . EVENTS), sorted by
+    MOMENT, with EVENTS a list of (EVENT . #t), as recorded by an
+    Event_recorder.
+  */
+  explicit Quote_store (SCM entries);
+  ~Quote_store ();
+
+  SCM mark_smob () const;
+
+  vsize size () const { return entries_.size (); }
+  Entry const &entry (vsize i) const { return entries_[i]; }
+  // The index of the first entry not before MOM.
+  vsize lower_bound (Moment const &mom) const;
+  // The events of entry I transposed by INTERVAL.
+  SCM transposed_events (vsize i, Pitch const &interval);
+  // The entries in the format given to the constructor.
+  SCM to_scm () const;
+
+private:
+  std::vector<Entry> entries_;
+  // Per interval, a vector with the transposed events of every entry,
+  // or #f for entries not transposed yet.
+  std::vector<std::pair<Pitch, SCM>> transposed_;
+};
+
+#endif /* QUOTE_STORE_HH */
@@ -45,6 +45,17 @@ struct Building
   bool above (Building const &other, Real x) const;
 };
 
+/*
+  A skyline together with the vertical (raise) and horizontal (shift)
+  offsets at which it takes part in a k-way merge.
+*/
+struct Placed_skyline
+{
+  Skyline const *skyline_;
+  Real raise_;
+  Real shift_;
+};
+
 class Skyline : public Simple_smob<Skyline>
 {
 public:
@@ -73,6 +84,7 @@ public:
   Skyline (std::vector<Box> const &bldgs, Axis a, Direction sky);
   Skyline (std::vector<Drul_array<Offset>> const &bldgs, Axis a, Direction sky);
   Skyline (std::vector<Skyline_pair> const &skypairs, Direction sky);
+  Skyline (std::vector<Placed_skyline> const &skylines, Direction sky);
   Skyline (Box const &b, Axis a, Direction sky);
 
   Direction sky () { return sky_; }
@@ -37,6 +37,9 @@ private:
   void precompute_method_bindings ();
   std::vector<Method_instance>
     precomputed_method_bindings_[TRANSLATOR_METHOD_PRECOMPUTE_COUNT];
+  // The bindings of translators that need idle time steps.
+  std::vector<Method_instance>
+    idle_method_bindings_[TRANSLATOR_METHOD_PRECOMPUTE_COUNT];
 
   SCM protected_events_;
 
@@ -65,6 +68,12 @@ public:
 protected:
   SCM simple_trans_list_;
   Context *context_;
+  // Whether a translator heard an event or a grob was announced in the
+  // current time step.  New groups start out active.
+  bool active_ = true;
+  // Whether grobs have been announced that are acknowledged only in the
+  // next time step.
+  virtual bool has_announcements () const { return false; }
 
   friend class Context_def;
   virtual void derived_mark () const;
@@ -153,6 +153,12 @@ public:
   virtual bool is_midi () const { return true; };
   virtual bool is_layout () const { return true; };
 
+  // Whether the time step methods must be called in time steps in which
+  // the context is idle, that is, none of its translators heard an event
+  // and no grob was announced to it.  Translators that only act on the
+  // events and grobs of the current time step return false.
+  virtual bool needs_idle_timesteps () const { return true; }
+
   virtual void connect_to_context () {}
   virtual void initialize () {}
   virtual void finalize () {}
@@ -109,6 +109,7 @@ Variable default_global_scale ("default-global-scale");
 Variable default_time_signature_settings ("default-time-signature-settings");
 Variable define_markup_command_internal ("define-markup-command-internal");
 Variable feta_design_size_mapping ("feta-design-size-mapping");
+Variable font_name_style ("font-name-style");
 Variable generate_crop_stencil ("generate-crop-stencil");
 Variable generate_preview_stencil ("generate-preview-stencil");
 Variable generate_system_stencils ("generate-system-stencils");
@@ -145,6 +146,8 @@ Variable markup_list_function_p ("markup-list-function?");
 Variable markup_list_p ("markup-list?");
 Variable markup_to_string ("markup->string");
 Variable midi_program ("midi-program");
+Variable modified_font_metric_font_scaling (
+  "modified-font-metric-font-scaling");
 Variable f_parser ("%parser");
 Variable output_scopes ("output-scopes");
 Variable percussion_p ("percussion?");
@@ -155,6 +158,9 @@ Variable scale_p ("scale?");
 Variable scale_to_factor ("scale->factor");
 Variable scale_layout ("scale-layout");
 Variable scm_to_string ("scm->string");
+Variable score_cache_key ("score-cache-key");
+Variable score_cache_read ("score-cache-read");
+Variable score_cache_store ("score-cache-store");
 Variable score_lines_markup_list ("score-lines-markup-list");
 Variable score_markup ("score-markup");
 Variable scorify_music ("scorify-music");
@@ -162,6 +168,7 @@ Variable stencil_whiteout ("stencil-whiteout");
 Variable stencil_with_color ("stencil-with-color");
 Variable symbol_list_p ("symbol-list?");
 Variable type_name ("type-name");
+Variable typeset_scores_in_workers ("typeset-scores-in-workers");
 Variable
   unbroken_or_first_broken_spanner_p ("unbroken-or-first-broken-spanner?");
 Variable unbroken_or_last_broken_spanner_p ("unbroken-or-last-broken-spanner?");
@@ -24,6 +24,7 @@
 #include "international.hh"
 #include "lily-lexer.hh"
 #include "main.hh"
+#include "phase-span.hh"
 #include "program-option.hh"
 #include "sources.hh"
 #include "warn.hh"
@@ -115,7 +116,10 @@ Parse a single @code{.ly} file.  Upon failure, throw @code{ly-file-failed} key.
       Lily_parser *parser = new Lily_parser (&sources);
 
       message (_ ("Parsing..."));
-      parser->parse_file (init, file_name, out_file);
+      {
+        Phase_span span ("parsing");
+        parser->parse_file (init, file_name, out_file);
+      }
 
       error = parser->error_level_;
 
@@ -151,7 +155,10 @@ Parse the init file @var{name}.
 
   Lily_parser *parser = new Lily_parser (&sources);
 
-  parser->parse_file (file_name, "<impossible>", "");
+  {
+    Phase_span span ("init-files");
+    parser->parse_file (file_name, "<impossible>", "");
+  }
 
   error = parser->error_level_;
 
@@ -20,10 +20,49 @@
 #include "moment.hh"
 
 #include "lily-guile.hh"
+#include "protected-scm.hh"
 #include "warn.hh"
 
+#include <cstdint>
+
 const char *const Moment::type_p_name_ = "ly:moment?";
 
+/*
+  Recently converted moments, in a direct-mapped table indexed by a
+  hash of the value.  Nothing modifies a Moment through its smob, so
+  the smobs can be shared; this saves allocating a new smob for every
+  time step and every music length.  Only finite values are kept,
+  since those have a unique representation.
+*/
+static const size_t MOMENT_CACHE_SIZE = 512; // a power of two
+
+SCM
+Moment::interned_smob () const
+{
+  if (!isfinite (main_part_) || !isfinite (grace_part_))
+    return smobbed_copy ();
+
+  static Protected_scm cache;
+  if (!cache.is_bound ())
+    cache = scm_c_make_vector (MOMENT_CACHE_SIZE, SCM_BOOL_F);
+
+  uint64_t h = static_cast<uint64_t> (main_part_.num ());
+  h = h * 31 + static_cast<uint64_t> (main_part_.den ());
+  h = h * 31 + static_cast<uint64_t> (grace_part_.num ());
+  h = h * 31 + static_cast<uint64_t> (grace_part_.den ());
+  h ^= h >> 17;
+  const size_t idx = h & (MOMENT_CACHE_SIZE - 1);
+
+  SCM entry = scm_c_vector_ref (cache, idx);
+  if (auto *const m = unsmob<Moment> (entry))
+    if (*m == *this)
+      return entry;
+
+  entry = smobbed_copy ();
+  scm_c_vector_set_x (cache, idx, entry);
+  return entry;
+}
+
 int
 Moment::print_smob (SCM port, scm_print_state *) const
 {
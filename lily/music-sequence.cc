@@ -108,7 +108,7 @@ Music_sequence::event_chord_length_callback (SCM m)
   if (d)
     {
       Moment mom (d->get_length ());
-      return mom.smobbed_copy ();
+      return to_scm (mom);
     }
   return maximum_length (get_property (me, "elements")).smobbed_copy ();
 }
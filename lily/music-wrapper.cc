@@ -29,9 +29,9 @@ Music_wrapper::start_callback (SCM m)
   auto *const me = LY_ASSERT_SMOB (Music, m, 1);
   Music *elt = unsmob<Music> (get_property (me, "element"));
   if (elt)
-    return elt->start_mom ().smobbed_copy ();
+    return to_scm (elt->start_mom ());
   else
-    return Moment ().smobbed_copy ();
+    return to_scm (Moment ());
 }
 
 MAKE_SCHEME_CALLBACK (Music_wrapper, length_callback,
@@ -42,7 +42,7 @@ Music_wrapper::length_callback (SCM m)
   auto *const me = LY_ASSERT_SMOB (Music, m, 1);
   Music *elt = unsmob<Music> (get_property (me, "element"));
   if (elt)
-    return elt->get_length ().smobbed_copy ();
+    return to_scm (elt->get_length ());
   else
-    return Moment (0).smobbed_copy ();
+    return to_scm (Moment (0));
 }
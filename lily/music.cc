@@ -25,6 +25,7 @@
 #include "input.hh"
 #include "international.hh"
 #include "music-sequence.hh"
+#include "protected-scm.hh"
 #include "score.hh"
 #include "warn.hh"
 #include "lily-imports.hh"
@@ -67,9 +68,49 @@ Music::derived_mark () const
   scm_gc_mark (start_callback_);
 }
 
+bool music_copy_on_write = false;
+
+// Whether X is music or a list structure containing music.
+static bool
+contains_music (SCM x)
+{
+  for (; scm_is_pair (x); x = scm_cdr (x))
+    if (contains_music (scm_car (x)))
+      return true;
+  return unsmob<Music> (x) != nullptr;
+}
+
+/*
+  Copy a property alist, only copying the values that contain music.
+  The other entries are shared with the original, which is why both
+  Music objects are marked as sharing their mutable properties.
+*/
+static SCM
+music_shared_copy (SCM alist)
+{
+  SCM copy = SCM_EOL;
+  bool copied = false;
+  for (SCM s = alist; scm_is_pair (s); s = scm_cdr (s))
+    {
+      SCM entry = scm_car (s);
+      if (scm_is_pair (entry) && contains_music (scm_cdr (entry)))
+        {
+          entry = scm_cons (scm_car (entry), music_deep_copy (scm_cdr (entry)));
+          copied = true;
+        }
+      copy = scm_cons (entry, copy);
+    }
+  return copied ? scm_reverse_x (copy, SCM_EOL) : alist;
+}
+
 SCM
 Music::copy_mutable_properties () const
 {
+  if (music_copy_on_write)
+    {
+      mutable_properties_shared_ = true;
+      return music_shared_copy (mutable_property_alist_);
+    }
   return music_deep_copy (mutable_property_alist_);
 }
 
@@ -84,21 +125,28 @@ Music::Music (Music const &m)
 {
   length_callback_ = m.length_callback_;
   start_callback_ = m.start_callback_;
+  // see copy_mutable_properties ()
+  mutable_properties_shared_ = music_copy_on_write;
 }
 
-Moment
-Music::get_length () const
+SCM
+Music::length_scm () const
 {
   SCM lst = get_property (this, "length");
-  if (auto *mom = unsmob<Moment> (lst))
-    return *mom;
+  if (unsmob<Moment> (lst))
+    return lst;
 
   if (ly_is_procedure (length_callback_))
-    {
-      SCM res = ly_call (length_callback_, self_scm ());
-      if (auto *mom = unsmob<Moment> (res))
-        return *mom;
-    }
+    return ly_call (length_callback_, self_scm ());
+
+  return SCM_BOOL_F;
+}
+
+Moment
+Music::get_length () const
+{
+  if (auto *mom = unsmob<Moment> (length_scm ()))
+    return *mom;
 
   return Moment (0);
 }
@@ -189,6 +237,7 @@ Prob::transpose (Pitch delta)
   if (from_scm<bool> (get_property (this, "untransposable")))
     return;
 
+  unshare_mutable_properties ();
   for (SCM s = mutable_property_alist_; scm_is_pair (s); s = scm_cdr (s))
     {
       SCM entry = scm_car (s);
@@ -239,11 +288,32 @@ Music::origin () const
 /*
   ES TODO: This method should probably be reworked or junked.
 */
+/*
+  The Lisp-style event class name of music named NAME (NoteEvent ->
+  note-event), converted once per name.  The event classes themselves
+  must be looked up every time, since define-event-class can add classes
+  and the table of classes is reset after each session.
+*/
+static SCM
+event_class_name (SCM name)
+{
+  static Protected_scm class_names;
+  if (!class_names.is_bound ())
+    class_names = scm_c_make_hash_table (131);
+
+  SCM class_name = scm_hashq_ref (class_names, name, SCM_BOOL_F);
+  if (scm_is_false (class_name))
+    {
+      class_name = ly_camel_case_2_lisp_identifier (name);
+      scm_hashq_set_x (class_names, name, class_name);
+    }
+  return class_name;
+}
+
 Stream_event *
 Music::to_event () const
 {
-  SCM class_name
-    = ly_camel_case_2_lisp_identifier (get_property (this, "name"));
+  SCM class_name = event_class_name (get_property (this, "name"));
 
   // catch programming mistakes.
   if (!internal_is_music_type (class_name))
@@ -251,9 +321,11 @@ Music::to_event () const
 
   Stream_event *e = new Stream_event (Lily::ly_make_event_class (class_name),
                                       mutable_property_alist_);
-  Moment length = get_length ();
-  if (length)
-    set_property (e, "length", length.smobbed_copy ());
+  // Moments are immutable, so the event can share the music's.
+  SCM length = length_scm ();
+  if (auto *mom = unsmob<Moment> (length))
+    if (*mom)
+      set_property (e, "length", length);
 
   // articulations as events.
   SCM art_mus = get_property (e, "articulations");
@@ -304,7 +376,7 @@ Music::duration_length_callback (SCM m)
   auto *const me = LY_ASSERT_SMOB (Music, m, 1);
   Duration *d = unsmob<Duration> (get_property (me, "duration"));
   Moment mom (d ? d->get_length () : 0);
-  return mom.smobbed_copy ();
+  return to_scm (mom);
 }
 
 SCM
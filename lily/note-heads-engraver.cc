@@ -38,6 +38,7 @@ class Note_heads_engraver : public Engraver
 
 public:
   TRANSLATOR_DECLARATIONS (Note_heads_engraver);
+  bool needs_idle_timesteps () const override { return false; }
 
 protected:
   void listen_note (Stream_event *);
@@ -0,0 +1,423 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2023 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "context-def.hh"
+#include "context-mod.hh"
+#include "duration.hh"
+#include "font-metric.hh"
+#include "glib-utils.hh"
+#include "input.hh"
+#include "lily-guile.hh"
+#include "moment.hh"
+#include "lily-imports.hh"
+#include "music-function.hh"
+#include "output-def.hh"
+#include "pitch.hh"
+#include "prob.hh"
+#include "protected-scm.hh"
+#include "quote-store.hh"
+#include "scale.hh"
+#include "stencil.hh"
+#include "unpure-pure-container.hh"
+
+#include <glib.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/*
+  A checksum of the contents of a Scheme value, which stays the same
+  across runs as long as the value is built from the same input.
+
+  Pointers never enter the checksum, except for objects of which we
+  cannot tell the contents: these make the checksum differ between
+  runs, which is safe for its use as a cache key.  Input locations are
+  left out, so that moving music around in a file does not change it.
+  The contents of hash tables and modules are added in an order
+  independent of the hash function.
+
+  Procedures are identified by name, or by their arity if anonymous,
+  only if they are part of LilyPond: procedures bound under their name
+  in the (lily) module, and the procedures registered with
+  ly:register-init-procedures, which are set up by the initialization
+  files.  All other procedures, in particular those written in the
+  input, count as objects of unknown contents, since their code and the
+  bindings they capture may change without changing their name.
+  has_unknown () tells whether any were met.
+*/
+class Object_digest
+{
+public:
+  Object_digest () : sum_ (g_checksum_new (G_CHECKSUM_SHA256)) {}
+  ~Object_digest () { g_checksum_free (sum_); }
+  Object_digest (Object_digest const &) = delete;
+  Object_digest &operator= (Object_digest const &) = delete;
+
+  void add (SCM);
+  std::string result () const { return g_checksum_get_string (sum_); }
+  // Whether the checksum depends on the run.
+  bool has_unknown () const { return has_unknown_; }
+  // Register the procedures met while adding instead of checking them.
+  void set_register_procedures () { register_procedures_ = true; }
+  // The digest of X on its own, for adding unordered collections.
+  std::string nested_digest (SCM x);
+
+private:
+  GChecksum *sum_;
+  // Modules and output definitions being added, to stop at cycles.
+  std::unordered_set<SCM> active_;
+  bool register_procedures_ = false;
+  bool has_unknown_ = false;
+
+  void add_tag (char c) { add_bytes (&c, 1); }
+  void add_bytes (char const *p, size_t n)
+  {
+    g_checksum_update (sum_, reinterpret_cast<guchar const *> (p),
+                       static_cast<gssize> (n));
+  }
+  void add_string (std::string const &s)
+  {
+    std::string len = std::to_string (s.length ()) + ":";
+    add_bytes (len.data (), len.length ());
+    add_bytes (s.data (), s.length ());
+  }
+  void add_unknown (SCM);
+  void add_procedure (SCM);
+  void add_unordered (std::vector<std::string> digests);
+  void add_alist (SCM alist);
+  void add_smob (SCM);
+  void add_module (SCM);
+  void add_hash_table (SCM);
+};
+
+std::string
+Object_digest::nested_digest (SCM x)
+{
+  Object_digest nested;
+  nested.active_ = active_;
+  nested.register_procedures_ = register_procedures_;
+  nested.add (x);
+  has_unknown_ |= nested.has_unknown_;
+  return nested.result ();
+}
+
+// Changes between runs, so that objects of unknown contents never give
+// the same checksum in two runs, even when they happen to be allocated
+// at the same address.
+static std::string const &
+run_salt ()
+{
+  static std::string const salt = [] {
+    std::random_device rd;
+    return std::to_string (rd ()) + "-" + std::to_string (rd ());
+  }();
+  return salt;
+}
+
+void
+Object_digest::add_unknown (SCM x)
+{
+  has_unknown_ = true;
+  add_tag ('?');
+  add_string (run_salt ());
+  add_string (ly_scm_write_string (x));
+  add_string (std::to_string (SCM_UNPACK (x)));
+}
+
+// Procedures set up by the initialization files.
+static Protected_scm init_procedures;
+
+static bool
+is_lilypond_procedure (SCM proc)
+{
+  if (init_procedures.is_bound ()
+      && scm_is_true (scm_hashq_ref (init_procedures, proc, SCM_BOOL_F)))
+    return true;
+
+  SCM name = scm_procedure_name (proc);
+  if (!scm_is_symbol (name))
+    return false;
+  SCM var = scm_module_variable (Lily::module, name);
+  return scm_is_true (var) && from_scm<bool> (scm_variable_bound_p (var))
+         && scm_is_eq (scm_variable_ref (var), proc);
+}
+
+void
+Object_digest::add_procedure (SCM proc)
+{
+  if (register_procedures_)
+    {
+      if (!init_procedures.is_bound ())
+        init_procedures = scm_c_make_hash_table (1021);
+      scm_hashq_set_x (init_procedures, proc, SCM_BOOL_T);
+    }
+  else if (!is_lilypond_procedure (proc))
+    {
+      add_unknown (proc);
+      return;
+    }
+
+  add_tag ('f');
+  SCM name = scm_procedure_name (proc);
+  if (scm_is_symbol (name))
+    add_string (ly_symbol2string (name));
+  else
+    add (scm_procedure_minimum_arity (proc));
+}
+
+void
+Object_digest::add_unordered (std::vector<std::string> digests)
+{
+  std::sort (digests.begin (), digests.end ());
+  add_string (std::to_string (digests.size ()));
+  for (auto const &d : digests)
+    add_string (d);
+}
+
+// Closure for collecting the digests of the entries of a hash table.
+struct Digest_collector
+{
+  Object_digest *self_;
+  std::vector<std::string> digests_;
+};
+
+void
+Object_digest::add_hash_table (SCM table)
+{
+  auto collect = [] (void *closure, SCM key, SCM val, SCM result) {
+    auto *c = static_cast<Digest_collector *> (closure);
+    c->digests_.push_back (c->self_->nested_digest (scm_cons (key, val)));
+    return result;
+  };
+  Digest_collector c {this, {}};
+  ly_scm_hash_fold (collect, &c, SCM_EOL, table);
+  add_tag ('h');
+  add_unordered (std::move (c.digests_));
+}
+
+/*
+  Variables that change while typesetting, as opposed to settings.
+*/
+static bool
+is_volatile_variable (SCM sym)
+{
+  return scm_is_eq (sym, ly_symbol2scm ("scaled-fonts"))
+         || scm_is_eq (sym, ly_symbol2scm ("pango-fonts"))
+         || scm_is_eq (sym, ly_symbol2scm ("label-page-table"))
+         || scm_is_eq (sym, ly_symbol2scm ("label-alist-table"));
+}
+
+void
+Object_digest::add_module (SCM mod)
+{
+  auto collect = [] (void *closure, SCM key, SCM var, SCM result) {
+    auto *c = static_cast<Digest_collector *> (closure);
+    if (!is_volatile_variable (key)
+        && from_scm<bool> (scm_variable_bound_p (var)))
+      c->digests_.push_back (
+        c->self_->nested_digest (scm_cons (key, scm_variable_ref (var))));
+    return result;
+  };
+  Digest_collector c {this, {}};
+  ly_scm_hash_fold (collect, &c, SCM_EOL, SCM_MODULE_OBARRAY (mod));
+  add_tag ('m');
+  add_unordered (std::move (c.digests_));
+}
+
+void
+Object_digest::add_alist (SCM alist)
+{
+  for (; scm_is_pair (alist); alist = scm_cdr (alist))
+    add (scm_car (alist));
+  add_tag (')');
+}
+
+void
+Object_digest::add_smob (SCM x)
+{
+  if (unsmob<Input> (x))
+    add_tag ('I');
+  else if (auto *p = unsmob<Prob> (x))
+    {
+      add_tag ('P');
+      add_string (p->class_name ());
+      add (p->type ());
+      add_alist (p->get_property_alist (true));
+      add_alist (p->get_property_alist (false));
+    }
+  else if (unsmob<Moment> (x) || unsmob<Pitch> (x) || unsmob<Duration> (x)
+           || unsmob<Scale> (x) || unsmob<Font_metric> (x))
+    {
+      // These print their complete value.
+      add_tag ('w');
+      add_string (ly_scm_write_string (x));
+    }
+  else if (auto *s = unsmob<const Stencil> (x))
+    {
+      add_tag ('S');
+      add (to_scm (s->extent (X_AXIS)));
+      add (to_scm (s->extent (Y_AXIS)));
+      add (s->expr ());
+    }
+  else if (auto *upc = unsmob<Unpure_pure_container> (x))
+    {
+      add_tag ('U');
+      add (upc->unpure_part ());
+      add (upc->pure_part ());
+    }
+  else if (auto *mf = unsmob<Music_function> (x))
+    {
+      add_tag ('F');
+      add (mf->get_signature ());
+      add (mf->get_function ());
+    }
+  else if (auto *q = unsmob<Quote_store> (x))
+    {
+      add_tag ('Q');
+      add (q->to_scm ());
+    }
+  else if (auto *cd = unsmob<Context_def> (x))
+    {
+      add_tag ('C');
+      add (cd->to_alist ());
+    }
+  else if (auto *cm = unsmob<Context_mod> (x))
+    {
+      add_tag ('M');
+      add (cm->get_mods ());
+    }
+  else if (auto *od = unsmob<Output_def> (x))
+    {
+      if (!active_.insert (x).second)
+        {
+          add_tag ('r');
+          return;
+        }
+      add_tag ('O');
+      add (od->scope_);
+      add (od->parent_ ? od->parent_->self_scm () : SCM_BOOL_F);
+      active_.erase (x);
+    }
+  else
+    add_unknown (x);
+}
+
+void
+Object_digest::add (SCM x)
+{
+  for (; scm_is_pair (x); x = scm_cdr (x))
+    {
+      add_tag ('(');
+      add (scm_car (x));
+    }
+
+  if (scm_is_null (x))
+    add_tag ('0');
+  else if (scm_is_bool (x))
+    add_tag (scm_is_true (x) ? 't' : 'f');
+  else if (scm_is_number (x))
+    {
+      add_tag ('n');
+      add_string (ly_scm2string (scm_number_to_string (x, to_scm (10))));
+    }
+  else if (scm_is_string (x))
+    {
+      add_tag ('s');
+      add_string (ly_scm2string (x));
+    }
+  else if (scm_is_symbol (x))
+    {
+      add_tag ('y');
+      add_string (ly_symbol2string (x));
+    }
+  else if (scm_is_keyword (x))
+    {
+      add_tag ('k');
+      add_string (ly_symbol2string (scm_keyword_to_symbol (x)));
+    }
+  else if (SCM_CHARP (x))
+    {
+      add_tag ('c');
+      add_string (std::to_string (SCM_CHAR (x)));
+    }
+  else if (scm_is_vector (x))
+    {
+      add_tag ('v');
+      size_t len = scm_c_vector_length (x);
+      add_string (std::to_string (len));
+      for (size_t i = 0; i < len; i++)
+        add (scm_c_vector_ref (x, i));
+    }
+  else if (ly_is_module (x))
+    {
+      if (!active_.insert (x).second)
+        {
+          add_tag ('r');
+          return;
+        }
+      add_module (x);
+      active_.erase (x);
+    }
+  else if (from_scm<bool> (scm_hash_table_p (x)))
+    add_hash_table (x);
+  else if (SCM_NIMP (x) && SCM_TYP7 (x) == scm_tc7_smob)
+    add_smob (x);
+  else if (ly_is_procedure (x))
+    add_procedure (x);
+  else if (scm_is_eq (x, SCM_UNSPECIFIED) || SCM_UNBNDP (x))
+    add_tag ('u');
+  else
+    add_unknown (x);
+}
+
+LY_DEFINE (ly_object_digest, "ly:object-digest", 1, 1, 0,
+           (SCM obj, SCM stable),
+           R"(
+Return a checksum of the contents of @var{obj} as a string of hexadecimal
+digits.  The checksum is meant to identify the same input across runs of
+LilyPond: input locations are ignored, the contents of modules, output
+definitions, context definitions, music and other property objects are
+included, and procedures that are part of LilyPond are identified by their
+name.  Other procedures and objects of which the contents are unknown make the
+checksum differ between runs; if @var{stable} is set, the result is @code{#f}
+instead.
+           )")
+{
+  Object_digest digest;
+  digest.add (obj);
+  if (from_scm<bool> (stable) && digest.has_unknown ())
+    return SCM_BOOL_F;
+  return ly_string2scm (digest.result ());
+}
+
+LY_DEFINE (ly_register_init_procedures, "ly:register-init-procedures", 1, 0,
+           0, (SCM obj),
+           R"(
+Register the procedures contained in @var{obj}, which has been set up by the
+initialization files, as part of LilyPond for @code{ly:object-digest}.
+           )")
+{
+  Object_digest digest;
+  digest.set_register_procedures ();
+  digest.add (obj);
+  return SCM_UNSPECIFIED;
+}
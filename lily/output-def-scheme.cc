@@ -19,6 +19,7 @@
 
 #include "output-def.hh"
 
+#include "all-font-metrics.hh"
 #include "pango-font.hh"
 #include "modified-font-metric.hh"
 #include "ly-module.hh"
@@ -176,6 +177,57 @@ list of alists, containing grob properties.)
   return fm->self_scm ();
 }
 
+LY_DEFINE (ly_paper_font_from_reference, "ly:paper-font-from-reference", 2, 0,
+           0, (SCM def, SCM reference),
+           R"(
+Find the font described by @var{reference}, as returned by
+@code{ly:font-reference}, and register it in output definition @var{def}
+(e.g., @code{\paper}) like @code{ly:paper-get-font} does.  Return @code{#f}
+if @var{reference} is not understood or the font cannot be found.
+           )")
+{
+  auto *const paper = LY_ASSERT_SMOB (Output_def, def, 1);
+  LY_ASSERT_TYPE (scm_is_pair, reference, 2);
+
+  SCM kind = scm_car (reference);
+  SCM args = scm_cdr (reference);
+  // Unlike find_otf_font, a missing font is not an error here: the
+  // reference may come from a run with other fonts installed.
+  std::string const otf_name
+    = scm_is_pair (args) && scm_is_string (scm_car (args))
+        ? ly_scm2string (scm_car (args))
+        : "";
+  if (scm_is_eq (kind, ly_symbol2scm ("scaled")) && !otf_name.empty ()
+      && scm_ilength (args) == 2 && scm_is_real (scm_cadr (args)))
+    {
+      if (!all_fonts_global->has_otf_font (otf_name))
+        return SCM_BOOL_F;
+      Font_metric *otf = all_fonts_global->find_otf_font (otf_name);
+      return find_unscaled_font (paper, otf, from_scm<Real> (scm_cadr (args)))
+        ->self_scm ();
+    }
+  if (scm_is_eq (kind, ly_symbol2scm ("otf")) && !otf_name.empty ()
+      && scm_ilength (args) == 1)
+    {
+      if (!all_fonts_global->has_otf_font (otf_name))
+        return SCM_BOOL_F;
+      return all_fonts_global->find_otf_font (otf_name)->self_scm ();
+    }
+  if (scm_is_eq (kind, ly_symbol2scm ("pango")) && scm_ilength (args) == 1
+      && scm_is_string (scm_car (args)))
+    {
+      PangoFontDescription *description = pango_font_description_from_string (
+        ly_scm2string (scm_car (args)).c_str ());
+      char const *family = pango_font_description_get_family (description);
+      bool is_emmentaler
+        = family && !g_ascii_strcasecmp (family, "emmentaler");
+      Font_metric *fm = find_pango_font (paper, description, is_emmentaler);
+      pango_font_description_free (description);
+      return fm->self_scm ();
+    }
+  return SCM_BOOL_F;
+}
+
 LY_DEFINE (ly_paper_get_number, "ly:paper-get-number", 2, 0, 0,
            (SCM def, SCM sym),
            R"(
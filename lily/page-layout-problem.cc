@@ -1085,6 +1085,9 @@ Page_layout_problem::build_system_skyline (
   Real first_spaceable_dy = 0;
   bool found_spaceable_staff = false;
 
+  // The skylines of the staves that have one, with their offsets.
+  std::vector<Skyline_pair> skylines;
+  std::vector<Real> skyline_dys;
   for (vsize i = 0; i < staves.size (); ++i)
     {
       Real dy = minimum_translations[i] - first_translation;
@@ -1092,14 +1095,8 @@ Page_layout_problem::build_system_skyline (
       SCM sky_scm = get_property (g, "vertical-skylines");
       if (is_scm<Skyline_pair> (sky_scm))
         {
-          const Skyline_pair &sky = from_scm<Skyline_pair> (sky_scm);
-          up->raise (-dy);
-          up->merge (sky[UP]);
-          up->raise (dy);
-
-          down->raise (-dy);
-          down->merge (sky[DOWN]);
-          down->raise (dy);
+          skylines.push_back (from_scm<Skyline_pair> (sky_scm));
+          skyline_dys.push_back (dy);
         }
       if (is_spaceable (staves[i]))
         {
@@ -1112,13 +1109,20 @@ Page_layout_problem::build_system_skyline (
         }
     }
 
-  // Leave the up skyline at a position relative
-  // to the top spaceable staff.
-  up->raise (-first_spaceable_dy);
-
-  // Leave the down skyline at a position
-  // relative to the bottom spaceable staff.
-  down->raise (-last_spaceable_dy);
+  // Leave the up skyline at a position relative to the top spaceable
+  // staff, and the down skyline at a position relative to the bottom
+  // spaceable staff.  All staves are merged in a single pass.
+  const Drul_array<Real> base (last_spaceable_dy, first_spaceable_dy);
+  Drul_array<Skyline *> result (down, up);
+  for (const auto d : {DOWN, UP})
+    {
+      std::vector<Placed_skyline> placed;
+      placed.reserve (skylines.size () + 1);
+      placed.push_back ({result[d], -base[d], 0.0});
+      for (vsize i = 0; i < skylines.size (); ++i)
+        placed.push_back ({&skylines[i][d], skyline_dys[i] - base[d], 0.0});
+      *result[d] = Skyline (placed, d);
+    }
 }
 
 Interval
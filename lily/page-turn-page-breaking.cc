@@ -149,6 +149,8 @@ Page_turn_page_breaking::calc_subproblem (vsize ending_breakpoint)
   Break_node cur;
   Break_node this_start_best;
   vsize prev_best_system_count = 0;
+  int const first_page_number
+    = from_scm (book_->paper ()->c_variable ("first-page-number"), 1);
 
   for (vsize start = end; start--;)
     {
@@ -160,8 +162,7 @@ Page_turn_page_breaking::calc_subproblem (vsize ending_breakpoint)
       if (start > 0 && best.demerits_ < state_[start - 1].demerits_)
         continue;
 
-      int p_num
-        = from_scm (book_->paper ()->c_variable ("first-page-number"), 1);
+      int p_num = first_page_number;
       if (start > 0)
         {
           /* except possibly for the first page, enforce the fact that first_page_number_
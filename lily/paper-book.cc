@@ -23,6 +23,7 @@
 #include "international.hh"
 #include "lily-imports.hh"
 #include "ly-module.hh"
+#include "ly-scm-list.hh"
 #include "main.hh"
 #include "output-def.hh"
 #include "page-marker.hh"
@@ -30,6 +31,8 @@
 #include "paper-def.hh"
 #include "paper-score.hh"
 #include "paper-system.hh"
+#include "phase-span.hh"
+#include "prob.hh"
 #include "program-option.hh"
 #include "std-vector.hh"
 #include "string-convert.hh"
@@ -219,6 +222,7 @@ all_formats ()
 void
 Paper_book::output (SCM output_channel)
 {
+  Phase_span span ("output");
   long first_page_number
     = from_scm (paper_->c_variable ("first-page-number"), 1);
   long first_performance_number = 0;
@@ -319,6 +323,7 @@ Paper_book::dump_header_fields (SCM basename, bool classic)
 void
 Paper_book::classic_output (SCM output)
 {
+  Phase_span span ("output");
   long first_performance_number = 0;
   classic_output_aux (output, &first_performance_number);
   dump_header_fields (output, true);
@@ -624,6 +629,35 @@ Paper_book::get_system_specs ()
               */
             }
         }
+      else if (Prob *cached = unsmob<Prob> (elem))
+        {
+          // The systems of a score read from the score cache.
+          assert (scm_is_eq (cached->type (), ly_symbol2scm ("cached-score")));
+          SCM title = get_score_title (header);
+
+          if (scm_is_true (last_system_spec))
+            set_system_penalty (last_system_spec, header);
+
+          if (unsmob<Prob> (title))
+            {
+              append_scm_list (&system_specs_tail, title);
+              last_system_spec = title;
+              unsmob<Prob> (title)->unprotect ();
+            }
+
+          header = SCM_EOL;
+          SCM systems = get_property (cached, "systems");
+          for (SCM sys : as_ly_scm_list (systems))
+            {
+              append_scm_list (&system_specs_tail, sys);
+              last_system_spec = sys;
+              if (scm_is_pair (labels))
+                {
+                  set_labels (sys, labels);
+                  labels = SCM_EOL;
+                }
+            }
+        }
       else if (Text_interface::is_markup_list (elem))
         {
           SCM texts = Lily::interpret_markup_list (paper_->self_scm (),
@@ -742,12 +776,18 @@ Paper_book::pages ()
     }
   else if (scm_is_pair (print_elements_))
     {
-      SCM page_breaking = paper_->c_variable ("page-breaking");
-      pages_ = ly_call (page_breaking, self_scm ());
+      {
+        Phase_span span ("page-breaking");
+        SCM page_breaking = paper_->c_variable ("page-breaking");
+        pages_ = ly_call (page_breaking, self_scm ());
+      }
 
       // Create all the page stencils.
-      for (SCM pages = pages_; scm_is_pair (pages); pages = scm_cdr (pages))
-        Page::page_stencil (scm_car (pages));
+      {
+        Phase_span span ("page-stencils");
+        for (SCM pages = pages_; scm_is_pair (pages); pages = scm_cdr (pages))
+          Page::page_stencil (scm_car (pages));
+      }
 
       // Perform any user-supplied post-processing.
       SCM post_process = paper_->c_variable ("page-post-process");
@@ -199,7 +199,7 @@ Paper_column_engraver::stop_translation_timestep ()
     return;
 
   // It would be safe to set "when" earlier, but there is no obvious need.
-  SCM m = now_mom ().smobbed_copy ();
+  SCM m = to_scm (now_mom ());
   set_property (command_column_, "when", m);
   set_property (musical_column_, "when", m);
 
@@ -56,7 +56,16 @@ find_scaled_font (Output_def *mod, Font_metric *f, Real m)
   if (mod->parent_)
     return find_scaled_font (mod->parent_, f, m);
 
-  Real lookup_mag = m / output_scale (mod);
+  return find_unscaled_font (mod, f, m / output_scale (mod));
+}
+
+/* Like find_scaled_font, but LOOKUP_MAG does not include the output
+   scale.  This is the magnification of the returned font.  */
+Font_metric *
+find_unscaled_font (Output_def *mod, Font_metric *f, Real lookup_mag)
+{
+  if (mod->parent_)
+    return find_unscaled_font (mod->parent_, f, lookup_mag);
 
   SCM font_table = get_font_table (mod);
   SCM sizes = scm_hashq_ref (font_table, f->self_scm (), SCM_EOL);
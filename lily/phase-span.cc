@@ -0,0 +1,272 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2023 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "phase-span.hh"
+
+#include "flower-proto.hh"
+#include "international.hh"
+#include "lily-guile.hh"
+#include "warn.hh"
+
+#include <gc/gc.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <unistd.h>
+#include <vector>
+
+bool Phase_span::phase_tracing_ = false;
+size_t Phase_span::gc_reserve_ = 0;
+
+struct Span_record
+{
+  char const *name_;
+  // microseconds since tracing started
+  double start_;
+  double duration_;
+  // garbage collector activity during the span
+  size_t allocated_;
+  size_t collections_;
+  double gc_seconds_;
+};
+
+static std::vector<Span_record> spans;
+static std::string trace_file;
+static Phase_span::Clock::time_point trace_start;
+
+static double
+microseconds (Phase_span::Clock::duration d)
+{
+  return std::chrono::duration<double, std::micro> (d).count ();
+}
+
+/*
+  Time spent in garbage collections, accumulated by GC hooks the way
+  Guile does for its gc-time-taken statistic, so that reading it does
+  not build the alist of scm_gc_stats.  The hook before a collection
+  runs inside the collector and must not allocate.
+*/
+static double gc_seconds = 0;
+static Phase_span::Clock::time_point gc_start;
+
+static void *
+note_gc_start (void *, void *, void *)
+{
+  gc_start = Phase_span::Clock::now ();
+  return nullptr;
+}
+
+static void *
+note_gc_end (void *, void *, void *)
+{
+  gc_seconds
+    += std::chrono::duration<double> (Phase_span::Clock::now () - gc_start)
+         .count ();
+  return nullptr;
+}
+
+bool
+Phase_span::is_debugging ()
+{
+  return is_loglevel (LOG_DEBUG);
+}
+
+Phase_span::Gc_counters
+Phase_span::Gc_counters::now ()
+{
+  static bool const hooks_added = [] {
+    scm_c_hook_add (&scm_before_gc_c_hook, note_gc_start, nullptr, 0);
+    scm_c_hook_add (&scm_after_gc_c_hook, note_gc_end, nullptr, 0);
+    return true;
+  }();
+  (void) hooks_added;
+
+  Gc_counters c;
+  c.allocated_ = GC_get_total_bytes ();
+  c.collections_ = GC_get_gc_no ();
+  c.seconds_ = gc_seconds;
+  return c;
+}
+
+void
+Phase_span::start ()
+{
+  if (gc_reserve_)
+    {
+      size_t free_bytes = GC_get_free_bytes ();
+      if (free_bytes < gc_reserve_)
+        GC_expand_hp (gc_reserve_ - free_bytes);
+    }
+
+  started_ = true;
+  gc_start_ = Gc_counters::now ();
+  start_ = Clock::now ();
+}
+
+void
+Phase_span::stop ()
+{
+  Clock::time_point end = Clock::now ();
+  Gc_counters gc_end = Gc_counters::now ();
+  Span_record r {name_,
+                 microseconds (start_ - trace_start),
+                 microseconds (end - start_),
+                 gc_end.allocated_ - gc_start_.allocated_,
+                 gc_end.collections_ - gc_start_.collections_,
+                 gc_end.seconds_ - gc_start_.seconds_};
+
+  if (phase_tracing_)
+    spans.push_back (r);
+  if (is_debugging ())
+    debug_output (_f ("%s: %.3f s, %.1f MiB allocated, "
+                      "%zu collections taking %.3f s",
+                      name_, r.duration_ * 1e-6,
+                      static_cast<double> (r.allocated_) / (1 << 20),
+                      r.collections_, r.gc_seconds_));
+}
+
+static void
+write_trace_events (FILE *out)
+{
+  int pid = static_cast<int> (getpid ());
+  fprintf (out, "{\"traceEvents\": [\n");
+  for (vsize i = 0; i < spans.size (); i++)
+    fprintf (out,
+             "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": %d, \"tid\": 0, "
+             "\"ts\": %.1f, \"dur\": %.1f, \"args\": {\"allocated\": %zu, "
+             "\"collections\": %zu, \"gc_seconds\": %.6f}}",
+             i ? ",\n" : "", spans[i].name_, pid, spans[i].start_,
+             spans[i].duration_, spans[i].allocated_, spans[i].collections_,
+             spans[i].gc_seconds_);
+  fprintf (out, "\n],\n\"displayTimeUnit\": \"ms\"}\n");
+}
+
+/*
+  Spans are properly nested unless a non-local exit skipped the end of
+  a span, in which case that span is simply missing.  The exclusive
+  time of a span is its duration minus that of its direct children.
+*/
+static void
+write_summary (FILE *out)
+{
+  std::vector<Span_record> sorted (spans);
+  std::sort (sorted.begin (), sorted.end (),
+             [] (Span_record const &a, Span_record const &b) {
+               return a.start_ < b.start_
+                      || (a.start_ == b.start_ && a.duration_ > b.duration_);
+             });
+
+  struct Totals
+  {
+    vsize count_ = 0;
+    double inclusive_ = 0;
+    double exclusive_ = 0;
+    size_t allocated_ = 0;
+    double gc_seconds_ = 0;
+  };
+  std::map<std::string, Totals> totals;
+  std::vector<double> exclusive (sorted.size ());
+  std::vector<vsize> open;
+  for (vsize i = 0; i < sorted.size (); i++)
+    {
+      Span_record const &s = sorted[i];
+      while (!open.empty ()
+             && sorted[open.back ()].start_ + sorted[open.back ()].duration_
+                  <= s.start_)
+        open.pop_back ();
+      if (!open.empty ())
+        exclusive[open.back ()] -= s.duration_;
+      exclusive[i] += s.duration_;
+      open.push_back (i);
+    }
+  for (vsize i = 0; i < sorted.size (); i++)
+    {
+      Totals &t = totals[sorted[i].name_];
+      t.count_++;
+      t.inclusive_ += sorted[i].duration_;
+      t.exclusive_ += exclusive[i];
+      t.allocated_ += sorted[i].allocated_;
+      t.gc_seconds_ += sorted[i].gc_seconds_;
+    }
+
+  std::vector<std::pair<std::string, Totals>> rows (totals.begin (),
+                                                    totals.end ());
+  std::sort (rows.begin (), rows.end (), [] (auto const &a, auto const &b) {
+    return a.second.exclusive_ > b.second.exclusive_;
+  });
+
+  // Allocation and GC time are inclusive.
+  fprintf (out, "%-20s %8s %14s %14s %14s %10s\n", "phase", "count",
+           "inclusive (s)", "exclusive (s)", "alloc. (MiB)", "GC (s)");
+  for (auto const &row : rows)
+    fprintf (out, "%-20s %8zu %14.3f %14.3f %14.1f %10.3f\n",
+             row.first.c_str (), row.second.count_,
+             row.second.inclusive_ * 1e-6, row.second.exclusive_ * 1e-6,
+             static_cast<double> (row.second.allocated_) / (1 << 20),
+             row.second.gc_seconds_);
+}
+
+static void
+write_trace ()
+{
+  if (trace_file.empty ())
+    return;
+
+  FILE *out = fopen (trace_file.c_str (), "w");
+  if (!out)
+    {
+      warning (_f ("cannot write trace file: `%s'", trace_file.c_str ()));
+      return;
+    }
+
+  std::string const ext = ".json";
+  if (trace_file.length () >= ext.length ()
+      && !trace_file.compare (trace_file.length () - ext.length (),
+                              ext.length (), ext))
+    write_trace_events (out);
+  else
+    write_summary (out);
+  fclose (out);
+}
+
+void
+Phase_span::set_trace_file (std::string const &file_name)
+{
+  if (!file_name.empty ())
+    {
+      static bool registered = false;
+      if (!registered)
+        {
+          atexit (write_trace);
+          registered = true;
+        }
+    }
+  // A job forked by -djob-count sets its own file and must not write the
+  // spans it inherited from the parent.  Setting the same file again, as
+  // ly:reset-options does after every input file, keeps the spans.
+  if (file_name != trace_file)
+    {
+      spans.clear ();
+      trace_start = Clock::now ();
+    }
+  trace_file = file_name;
+  phase_tracing_ = !file_name.empty ();
+}
@@ -23,6 +23,9 @@
 #include "input.hh"
 #include "profile.hh"
 
+#include <algorithm>
+#include <iterator>
+
 const char *const Prob::type_p_name_ = "ly:prob?";
 
 SCM
@@ -91,6 +94,7 @@ Prob::Prob (SCM type, SCM immutable_init)
   mutable_property_alist_ = SCM_EOL;
   immutable_property_alist_ = immutable_init;
   type_ = type;
+  forget_hot_properties ();
   smobify_self ();
 }
 
@@ -104,6 +108,7 @@ Prob::Prob (Prob const &src)
   immutable_property_alist_ = src.immutable_property_alist_;
   mutable_property_alist_ = SCM_EOL;
   type_ = src.type_;
+  forget_hot_properties ();
 
   /* First we smobify_self, then we copy over the stuff.  If we don't,
      stack vars that hold the copy might be optimized away, meaning
@@ -112,6 +117,46 @@ Prob::Prob (Prob const &src)
   mutable_property_alist_ = src.copy_mutable_properties ();
 }
 
+void
+Prob::unshare_mutable_properties ()
+{
+  if (mutable_properties_shared_)
+    {
+      mutable_property_alist_ = ly_alist_copy (mutable_property_alist_);
+      mutable_properties_shared_ = false;
+      forget_hot_properties ();
+    }
+}
+
+void
+Prob::forget_hot_properties ()
+{
+  std::fill_n (hot_property_handles_, HOT_PROPERTY_COUNT, SCM_UNDEFINED);
+}
+
+/*
+  The slot of SYM in hot_property_handles_, or HOT_PROPERTY_COUNT if
+  it has none.  These are the properties that engravers, performers
+  and the dispatcher look up for nearly every event.
+*/
+size_t
+Prob::hot_property_slot (SCM sym)
+{
+  static SCM const symbols[] = {
+    ly_symbol2scm ("class"),  ly_symbol2scm ("duration"),
+    ly_symbol2scm ("pitch"),  ly_symbol2scm ("origin"),
+    ly_symbol2scm ("tweaks"), ly_symbol2scm ("articulations"),
+    ly_symbol2scm ("name"),   ly_symbol2scm ("types"),
+  };
+  static_assert (std::size (symbols) == HOT_PROPERTY_COUNT,
+                 "one symbol per slot");
+
+  for (size_t i = 0; i < std::size (symbols); i++)
+    if (scm_is_eq (symbols[i], sym))
+      return i;
+  return std::size (symbols);
+}
+
 SCM
 Prob::copy_mutable_properties () const
 {
@@ -129,6 +174,8 @@ Prob::mark_smob () const
   ASSERT_LIVE_IS_ALLOWED (self_scm ());
 
   scm_gc_mark (mutable_property_alist_);
+  for (SCM handle : hot_property_handles_)
+    scm_gc_mark (handle);
   derived_mark ();
 
   return immutable_property_alist_;
@@ -160,12 +207,28 @@ Prob::internal_get_property (SCM sym) const
   /*
     TODO: type checking
    */
+  SCM handle;
+  const size_t slot = hot_property_slot (sym);
+  if (slot < HOT_PROPERTY_COUNT)
+    {
+      handle = hot_property_handles_[slot];
+      if (SCM_UNBNDP (handle))
+        hot_property_handles_[slot] = handle = property_handle (sym);
+    }
+  else
+    handle = property_handle (sym);
+
+  return scm_is_false (handle) ? SCM_EOL : scm_cdr (handle);
+}
+
+SCM
+Prob::property_handle (SCM sym) const
+{
   SCM s = scm_sloppy_assq (sym, mutable_property_alist_);
   if (scm_is_true (s))
-    return scm_cdr (s);
+    return s;
 
-  s = scm_sloppy_assq (sym, immutable_property_alist_);
-  return scm_is_false (s) ? SCM_EOL : scm_cdr (s);
+  return scm_sloppy_assq (sym, immutable_property_alist_);
 }
 
 /* We don't (yet) instrument probs */
@@ -182,7 +245,12 @@ Prob::internal_set_property (SCM sym, SCM val)
   if (do_internal_type_checking_global)
     type_check_assignment (sym, val);
 
+  unshare_mutable_properties ();
   mutable_property_alist_ = scm_assq_set_x (mutable_property_alist_, sym, val);
+
+  const size_t slot = hot_property_slot (sym);
+  if (slot < HOT_PROPERTY_COUNT)
+    hot_property_handles_[slot] = SCM_UNDEFINED;
 }
 
 void
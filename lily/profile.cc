@@ -18,8 +18,16 @@
 */
 
 #include "profile.hh"
+
+#include "grob.hh"
 #include "protected-scm.hh"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
 Protected_scm context_property_lookup_table;
 Protected_scm grob_property_lookup_table;
 Protected_scm prob_property_lookup_table;
@@ -62,3 +70,266 @@ note_property_access (Protected_scm *table, SCM sym)
   int count = from_scm<int> (scm_cdr (hashhandle)) + 1;
   scm_set_cdr_x (hashhandle, to_scm (count));
 }
+
+/*
+  Callback profiling.  The statistics are kept in C++ so that a timed
+  callback does not allocate; the Scheme objects used as keys are kept
+  alive through callback_profile_keys.
+*/
+namespace
+{
+struct Callback_key
+{
+  SCM grob_name_;
+  SCM sym_;
+  SCM proc_;
+
+  bool operator== (Callback_key const &k) const
+  {
+    return scm_is_eq (grob_name_, k.grob_name_) && scm_is_eq (sym_, k.sym_)
+           && scm_is_eq (proc_, k.proc_);
+  }
+};
+
+struct Callback_key_hash
+{
+  size_t operator() (Callback_key const &k) const
+  {
+    std::hash<void *> h;
+    return (h (SCM2PTR (k.grob_name_)) * 31 + h (SCM2PTR (k.sym_))) * 31
+           + h (SCM2PTR (k.proc_));
+  }
+};
+
+struct Callback_stats
+{
+  vsize count_ = 0;
+  // seconds
+  double inclusive_ = 0;
+  double exclusive_ = 0;
+};
+} // namespace
+
+static std::unordered_map<Callback_key, Callback_stats, Callback_key_hash>
+  callback_stats;
+static Protected_scm callback_profile_keys;
+// Time spent in nested callbacks, per active frame.
+static std::vector<double> callback_child_time;
+
+void
+Callback_profile_frame::start (Grob *grob, SCM sym, SCM proc)
+{
+  SCM meta = get_property (grob, "meta");
+  grob_name_ = ly_assoc_get (ly_symbol2scm ("name"), meta, SCM_BOOL_F);
+  sym_ = sym;
+  proc_ = proc;
+  depth_ = callback_child_time.size ();
+  callback_child_time.push_back (0.0);
+  active_ = true;
+  start_ = std::chrono::steady_clock::now ();
+}
+
+void
+Callback_profile_frame::stop ()
+{
+  double elapsed = std::chrono::duration<double> (
+                     std::chrono::steady_clock::now () - start_)
+                     .count ();
+
+  // Frames above ours were left by a non-local exit; drop them.
+  callback_child_time.resize (depth_ + 1);
+  double children = callback_child_time.back ();
+  callback_child_time.pop_back ();
+  if (depth_ > 0)
+    callback_child_time[depth_ - 1] += elapsed;
+
+  Callback_key key {grob_name_, sym_, proc_};
+  auto it = callback_stats.find (key);
+  if (it == callback_stats.end ())
+    {
+      if (!callback_profile_keys.is_bound ())
+        callback_profile_keys = SCM_EOL;
+      callback_profile_keys = scm_cons (ly_list (grob_name_, sym_, proc_),
+                                        callback_profile_keys);
+      it = callback_stats.emplace (key, Callback_stats ()).first;
+    }
+  Callback_stats &stats = it->second;
+  stats.count_++;
+  stats.inclusive_ += elapsed;
+  stats.exclusive_ += elapsed - children;
+}
+
+static std::vector<std::pair<Callback_key, Callback_stats>>
+sorted_callback_stats ()
+{
+  std::vector<std::pair<Callback_key, Callback_stats>> rows (
+    callback_stats.begin (), callback_stats.end ());
+  std::sort (rows.begin (), rows.end (), [] (auto const &a, auto const &b) {
+    return a.second.exclusive_ > b.second.exclusive_;
+  });
+  return rows;
+}
+
+static std::string
+callback_name (SCM proc)
+{
+  SCM name = scm_procedure_name (proc);
+  return scm_is_symbol (name) ? ly_symbol2string (name)
+                              : ly_scm_write_string (proc);
+}
+
+static void
+print_callback_profile ()
+{
+  // The option may have been switched off after collecting statistics.
+  if (!profile_callbacks || callback_stats.empty ())
+    return;
+
+  fprintf (stderr, "\n%-24s %-24s %10s %12s %12s  %s\n", "grob", "property",
+           "count", "incl. (s)", "excl. (s)", "procedure");
+  for (auto const &row : sorted_callback_stats ())
+    {
+      Callback_key const &k = row.first;
+      Callback_stats const &s = row.second;
+      std::string grob = scm_is_symbol (k.grob_name_)
+                           ? ly_symbol2string (k.grob_name_)
+                           : "?";
+      fprintf (stderr, "%-24s %-24s %10zu %12.4f %12.4f  %s\n", grob.c_str (),
+               ly_symbol2string (k.sym_).c_str (), s.count_, s.inclusive_,
+               s.exclusive_, callback_name (k.proc_).c_str ());
+    }
+}
+
+void
+set_callback_profiling (bool on)
+{
+  static bool registered = false;
+  if (on && !registered)
+    {
+      atexit (print_callback_profile);
+      registered = true;
+    }
+  profile_callbacks = on;
+}
+
+namespace
+{
+struct Startup_item
+{
+  std::string kind_;
+  std::string name_;
+  vsize depth_;
+  // seconds, negative if the item was left by a non-local exit
+  double seconds_ = -1;
+  std::chrono::steady_clock::time_point start_;
+};
+} // namespace
+
+static std::vector<Startup_item> startup_items;
+// Indices of the open items in startup_items.
+static std::vector<vsize> open_startup_items;
+
+vsize
+startup_profile_enter (std::string const &kind, std::string const &name)
+{
+  if (!profile_startup)
+    return VPOS;
+
+  Startup_item item;
+  item.kind_ = kind;
+  item.name_ = name;
+  item.depth_ = open_startup_items.size ();
+  item.start_ = std::chrono::steady_clock::now ();
+  open_startup_items.push_back (startup_items.size ());
+  startup_items.push_back (item);
+  return startup_items.size () - 1;
+}
+
+void
+startup_profile_leave (vsize item)
+{
+  if (item == VPOS)
+    return;
+
+  startup_items[item].seconds_
+    = std::chrono::duration<double> (std::chrono::steady_clock::now ()
+                                     - startup_items[item].start_)
+        .count ();
+  // Items above ours were left by a non-local exit; drop them.
+  while (!open_startup_items.empty () && open_startup_items.back () >= item)
+    open_startup_items.pop_back ();
+}
+
+LY_DEFINE (ly_startup_profile_item, "ly:startup-profile-item", 3, 0, 0,
+           (SCM kind, SCM name, SCM thunk),
+           R"(
+Call @var{thunk}, recording it in the startup profile as an item of the
+given @var{kind} (a symbol) and @var{name} (a string) if the
+@code{startup-profile} option is set.  Return the result of @var{thunk}.
+           )")
+{
+  LY_ASSERT_TYPE (ly_is_symbol, kind, 1);
+  LY_ASSERT_TYPE (scm_is_string, name, 2);
+  LY_ASSERT_TYPE (ly_is_procedure, thunk, 3);
+
+  vsize item
+    = startup_profile_enter (ly_symbol2string (kind), ly_scm2string (name));
+  SCM result = scm_call_0 (thunk);
+  startup_profile_leave (item);
+  return result;
+}
+
+LY_DEFINE (ly_finish_startup_profile, "ly:finish-startup-profile", 0, 0, 0,
+           (),
+           R"(
+Stop recording the startup profile and print it to the error output: the
+time taken by every Scheme file loaded and every init file read so far, with
+nested items indented below the item that loaded them.
+           )")
+{
+  if (!profile_startup)
+    return SCM_UNSPECIFIED;
+  profile_startup = false;
+
+  double total = 0;
+  fprintf (stderr, "\n%-10s %-52s %12s\n", "kind", "startup item",
+           "time (s)");
+  for (auto const &item : startup_items)
+    {
+      std::string name = std::string (2 * item.depth_, ' ') + item.name_;
+      if (item.seconds_ < 0)
+        fprintf (stderr, "%-10s %-52s %12s\n", item.kind_.c_str (),
+                 name.c_str (), "(aborted)");
+      else
+        fprintf (stderr, "%-10s %-52s %12.4f\n", item.kind_.c_str (),
+                 name.c_str (), item.seconds_);
+      if (!item.depth_ && item.seconds_ > 0)
+        total += item.seconds_;
+    }
+  fprintf (stderr, "%-10s %-52s %12.4f\n", "", "total", total);
+  return SCM_UNSPECIFIED;
+}
+
+LY_DEFINE (ly_callback_profile, "ly:callback-profile", 0, 0, 0, (),
+           R"(
+Return the statistics collected for grob property callbacks when the
+@code{profile-callbacks} option is set.  The result is a list with an entry
+@code{(@var{grob} @var{property} @var{procedure} @var{count} @var{inclusive}
+@var{exclusive})} for every combination of grob name, property and callback
+procedure, sorted by decreasing exclusive time.  Times are in seconds; the
+exclusive time of a callback does not include callbacks it triggered.
+           )")
+{
+  SCM result = SCM_EOL;
+  auto const rows = sorted_callback_stats ();
+  for (vsize i = rows.size (); i--;)
+    {
+      Callback_key const &k = rows[i].first;
+      Callback_stats const &s = rows[i].second;
+      result = scm_cons (ly_list (k.grob_name_, k.sym_, k.proc_,
+                                  to_scm (s.count_), to_scm (s.inclusive_),
+                                  to_scm (s.exclusive_)),
+                         result);
+    }
+  return result;
+}
@@ -20,6 +20,7 @@
 #include "program-option.hh"
 
 #include "profile.hh"
+#include "phase-span.hh"
 #include "international.hh"
 #include "lily-imports.hh"
 #include "ly-scm-list.hh"
@@ -43,6 +44,8 @@ bool music_strings_to_paths;
 bool relative_includes;
 
 bool profile_property_accesses = false;
+bool profile_callbacks = false;
+bool profile_startup = false;
 /*
   crash if internally the wrong type is used for a grob property.
 */
@@ -64,6 +67,16 @@ internal_set_option (SCM var, SCM val)
       profile_property_accesses = valbool;
       val = val_scm_bool;
     }
+  else if (varstr == "profile-callbacks")
+    {
+      set_callback_profiling (valbool);
+      val = val_scm_bool;
+    }
+  else if (varstr == "startup-profile")
+    {
+      profile_startup = valbool;
+      val = val_scm_bool;
+    }
   else if (varstr == "protected-scheme-parsing")
     {
       parse_protect_global = valbool;
@@ -115,6 +128,26 @@ internal_set_option (SCM var, SCM val)
       warning_as_error = valbool;
       val = val_scm_bool;
     }
+  else if (varstr == "trace-file")
+    {
+      if (scm_is_symbol (val))
+        val = scm_symbol_to_string (val);
+      Phase_span::set_trace_file (scm_is_string (val) ? ly_scm2string (val)
+                                                      : "");
+    }
+  else if (varstr == "gc-phase-reserve")
+    {
+      // in megabytes
+      Phase_span::set_gc_reserve (
+        scm_is_real (val) && from_scm<double> (val) > 0
+          ? static_cast<size_t> (from_scm<double> (val) * (1 << 20))
+          : 0);
+    }
+  else if (varstr == "music-copy-on-write")
+    {
+      music_copy_on_write = valbool;
+      val = val_scm_bool;
+    }
   else if (varstr == "music-strings-to-paths")
     {
       music_strings_to_paths = valbool;
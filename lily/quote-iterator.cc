@@ -24,8 +24,10 @@
 #include "input.hh"
 #include "international.hh"
 #include "lily-guile.hh"
+#include "ly-scm-list.hh"
 #include "music-sequence.hh"
 #include "music.hh"
+#include "quote-store.hh"
 #include "warn.hh"
 
 #include <string>
@@ -39,13 +41,11 @@ public:
   // zero moment of this music in the timeline of the score; unknown until the
   // first call to process ()
   Moment zero_mom_ = -Moment::infinity ();
-  SCM event_vector_ = SCM_EOL;
+  Quote_store *quotes_ = nullptr;
   vsize event_idx_ = 0; // left closed
   vsize end_idx_ = 0;   // right open
   bool first_time_ = true;
 
-  SCM transposed_musics_ = SCM_EOL;
-
   DECLARE_SCHEME_CALLBACK (constructor, ());
   bool accept_music_type (Stream_event *, bool is_cue = true) const;
 
@@ -88,29 +88,8 @@ void
 Quote_iterator::derived_mark () const
 {
   Music_wrapper_iterator::derived_mark ();
-  scm_gc_mark (transposed_musics_);
-}
-
-// lower bound: binary search returning the index of the first element that is
-// not less than the key
-vsize
-binsearch_scm_vector (SCM vec, SCM key, bool is_less (SCM a, SCM b))
-{
-  vsize lo = 0;
-  vsize hi = scm_c_vector_length (vec);
-
-  while (lo < hi)
-    {
-      vsize cmp = (lo + hi) / 2;
-
-      SCM when = scm_caar (scm_c_vector_ref (vec, cmp));
-      if (is_less (when, key))
-        lo = cmp + 1;
-      else
-        hi = cmp;
-    }
-
-  return lo;
+  if (quotes_)
+    scm_gc_mark (quotes_->self_scm ());
 }
 
 void
@@ -118,7 +97,8 @@ Quote_iterator::create_children ()
 {
   Music_wrapper_iterator::create_children ();
 
-  event_vector_ = get_property (get_music (), "quoted-events");
+  quotes_
+    = unsmob<Quote_store> (get_property (get_music (), "quoted-events"));
 }
 
 void
@@ -153,15 +133,7 @@ Quote_iterator::pending_moment () const
   auto m = Music_wrapper_iterator::pending_moment ();
 
   if (event_idx_ < end_idx_)
-    {
-      SCM entry = scm_c_vector_ref (event_vector_, event_idx_);
-      if (auto *const event_mom = unsmob<Moment> (scm_caar (entry)))
-        {
-          // If event_mom is not a moment, process () should issue a diagnostic
-          // later, so just ignore it here.
-          m = std::min (m, *event_mom - zero_mom_);
-        }
-    }
+    m = std::min (m, quotes_->entry (event_idx_).when_ - zero_mom_);
 
   return m;
 }
@@ -181,7 +153,7 @@ Quote_iterator::process (Moment m)
 
       zero_mom_ = start_mom - music_start_mom ();
 
-      if (scm_is_vector (event_vector_))
+      if (quotes_)
         {
           // To quote grace notes, the user currently has to provide grace time
           // in the wrapped music.  It would be nicer to include all grace
@@ -190,8 +162,7 @@ Quote_iterator::process (Moment m)
           // main part) before the first call to pending_moment ().  It
           // possibly also requires improvements to handle music where the
           // grace part of the start moment is unknown prior to iteration.
-          event_idx_ = binsearch_scm_vector (
-            event_vector_, start_mom.smobbed_copy (), moment_less);
+          event_idx_ = quotes_->lower_bound (start_mom);
 
           // end moment of this music, excluding any grace notes leading to an
           // unquoted note
@@ -199,30 +170,16 @@ Quote_iterator::process (Moment m)
                                   + music_get_length ().main_part_,
                                 -Rational::infinity ());
 
-          end_idx_ = binsearch_scm_vector (
-            event_vector_, end_mom.smobbed_copy (), moment_less);
+          end_idx_ = quotes_->lower_bound (end_mom);
         }
     }
 
   m = zero_mom_ + m;
   for (/**/; event_idx_ < end_idx_; ++event_idx_)
     {
-      SCM entry = scm_c_vector_ref (event_vector_, event_idx_);
-
-      if (auto *const event_mom = unsmob<Moment> (scm_caar (entry)))
-        {
-          if (*event_mom > m) // not time to process this entry yet
-            return;
-        }
-      else
-        {
-          std::string s ("expected moment in event vector: ");
-          s += ly_scm_write_string (scm_caar (entry));
-          programming_error (s);
-          continue;
-        }
-
-      Pitch *quote_pitch = unsmob<Pitch> (scm_cdar (entry));
+      auto const &entry = quotes_->entry (event_idx_);
+      if (entry.when_ > m) // not time to process this entry yet
+        return;
 
       /*
         The pitch that sounds when written central C is played.
@@ -245,33 +202,25 @@ Quote_iterator::process (Moment m)
       SCM cid = get_property (get_music (), "quoted-context-id");
       bool is_cue = scm_is_string (cid) && (ly_scm2string (cid) == "cue");
 
-      for (SCM s = scm_cdr (entry); scm_is_pair (s); s = scm_cdr (s))
+      /* use transposed copies if necessary */
+      SCM events = entry.events_;
+      if (entry.has_transposition_ || me_pitch)
         {
-          SCM ev_acc = scm_car (s);
+          Pitch mp;
+          if (me_pitch)
+            mp = *me_pitch;
 
-          Stream_event *ev = unsmob<Stream_event> (scm_car (ev_acc));
+          Pitch diff = pitch_interval (mp, entry.transposition_);
+          events = quotes_->transposed_events (event_idx_, diff);
+        }
+
+      for (SCM s : as_ly_scm_list (events))
+        {
+          Stream_event *ev = unsmob<Stream_event> (s);
           if (!ev)
             programming_error ("no music found in quote");
           else if (accept_music_type (ev, is_cue))
-            {
-              /* create a transposed copy if necessary */
-              if (quote_pitch || me_pitch)
-                {
-                  Pitch qp, mp;
-                  if (quote_pitch)
-                    qp = *quote_pitch;
-                  if (me_pitch)
-                    mp = *me_pitch;
-
-                  Pitch diff = pitch_interval (mp, qp);
-                  ev = ev->clone ();
-                  ev->make_transposable ();
-                  ev->transpose (diff);
-                  transposed_musics_
-                    = scm_cons (ev->unprotect (), transposed_musics_);
-                }
-              quote_handle_->event_source ()->broadcast (ev);
-            }
+            quote_handle_->event_source ()->broadcast (ev);
         }
     }
 }
@@ -0,0 +1,169 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2023 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "quote-store.hh"
+
+#include "lily-guile.hh"
+#include "ly-scm-list.hh"
+#include "stream-event.hh"
+
+#include <algorithm>
+
+const char *const Quote_store::type_p_name_ = "ly:quote-store?";
+
+Quote_store::Quote_store (SCM entries)
+{
+  for (SCM entry : as_ly_scm_list (entries))
+    {
+      Pitch *p = unsmob<Pitch> (scm_cdar (entry));
+      SCM events = SCM_EOL;
+      for (SCM ev_acc : ly_scm_list (scm_cdr (entry)))
+        events = scm_cons (scm_car (ev_acc), events);
+      entries_.push_back ({*unsmob<Moment> (scm_caar (entry)),
+                           p ? *p : Pitch (), p != nullptr,
+                           scm_reverse_x (events, SCM_EOL)});
+    }
+  smobify_self ();
+}
+
+Quote_store::~Quote_store ()
+{
+}
+
+SCM
+Quote_store::mark_smob () const
+{
+  for (auto const &e : entries_)
+    scm_gc_mark (e.events_);
+  for (auto const &t : transposed_)
+    scm_gc_mark (t.second);
+  return SCM_EOL;
+}
+
+vsize
+Quote_store::lower_bound (Moment const &mom) const
+{
+  auto it = std::lower_bound (
+    entries_.begin (), entries_.end (), mom,
+    [] (Entry const &e, Moment const &m) { return e.when_ < m; });
+  return it - entries_.begin ();
+}
+
+SCM
+Quote_store::transposed_events (vsize i, Pitch const &interval)
+{
+  SCM table = SCM_BOOL_F;
+  for (auto const &t : transposed_)
+    if (!Pitch::compare (t.first, interval))
+      {
+        table = t.second;
+        break;
+      }
+  if (scm_is_false (table))
+    {
+      table = scm_c_make_vector (entries_.size (), SCM_BOOL_F);
+      transposed_.emplace_back (interval, table);
+    }
+
+  SCM events = scm_c_vector_ref (table, i);
+  if (scm_is_false (events))
+    {
+      events = SCM_EOL;
+      for (SCM s : as_ly_scm_list (entries_[i].events_))
+        {
+          if (auto *ev = unsmob<Stream_event> (s))
+            {
+              ev = ev->clone ();
+              ev->make_transposable ();
+              ev->transpose (interval);
+              s = ev->unprotect ();
+            }
+          events = scm_cons (s, events);
+        }
+      events = scm_reverse_x (events, SCM_EOL);
+      scm_c_vector_set_x (table, i, events);
+    }
+  return events;
+}
+
+SCM
+Quote_store::to_scm () const
+{
+  SCM result = SCM_EOL;
+  for (auto const &e : entries_)
+    {
+      SCM events = SCM_EOL;
+      for (SCM ev : as_ly_scm_list (e.events_))
+        events = scm_cons (scm_cons (ev, SCM_BOOL_T), events);
+      SCM key = scm_cons (e.when_.smobbed_copy (),
+                          e.has_transposition_
+                            ? e.transposition_.smobbed_copy ()
+                            : SCM_BOOL_F);
+      result = scm_cons (scm_cons (key, scm_reverse_x (events, SCM_EOL)),
+                         result);
+    }
+  return scm_reverse_x (result, SCM_EOL);
+}
+
+LY_DEFINE (ly_make_quote_store, "ly:make-quote-store", 1, 0, 0, (SCM entries),
+           R"(
+Make a store for quoting the events in @var{entries}, a list of time steps
+@code{((@var{moment} . @var{transposition}) . @var{events})} in chronological
+order, as returned for a context by @code{ly:event-recorder-contents} after
+reversing.  @var{transposition} is the @code{instrumentTransposition} in
+effect or @code{#f}, and @var{events} is a list of @code{(@var{event} . #t)}
+pairs.
+           )")
+{
+  bool type_ok = ly_is_list (entries);
+  Moment prev = -Moment::infinity ();
+  for (SCM s = entries; type_ok && scm_is_pair (s); s = scm_cdr (s))
+    {
+      SCM entry = scm_car (s);
+      type_ok = scm_is_pair (entry) && scm_is_pair (scm_car (entry))
+                && ly_is_list (scm_cdr (entry));
+      if (type_ok)
+        {
+          auto *mom = unsmob<Moment> (scm_caar (entry));
+          type_ok = mom && !(*mom < prev);
+          if (type_ok)
+            prev = *mom;
+        }
+      for (SCM e = type_ok ? scm_cdr (entry) : SCM_EOL; scm_is_pair (e);
+           e = scm_cdr (e))
+        type_ok = type_ok && scm_is_pair (scm_car (e));
+    }
+
+  SCM_ASSERT_TYPE (type_ok, entries, SCM_ARG1, __FUNCTION__,
+                   "chronological list of quote entries");
+
+  return (new Quote_store (entries))->unprotect ();
+}
+
+LY_DEFINE (ly_quote_store_entries, "ly:quote-store-entries", 1, 0, 0,
+           (SCM store),
+           R"(
+Return the entries of the quote store @var{store} in the format accepted by
+@code{ly:make-quote-store}.
+           )")
+{
+  auto *const q = LY_ASSERT_SMOB (Quote_store, store, 1);
+  return q->to_scm ();
+}
@@ -41,6 +41,7 @@ protected:
 
 public:
   TRANSLATOR_DECLARATIONS (Rest_engraver);
+  bool needs_idle_timesteps () const override { return false; }
 };
 
 /*
@@ -60,6 +60,7 @@ class Rhythmic_column_engraver : public Engraver
   Grob *note_column_;
 
   TRANSLATOR_DECLARATIONS (Rhythmic_column_engraver);
+  bool needs_idle_timesteps () const override { return false; }
 
 protected:
   void acknowledge_stem (Grob_info);
@@ -24,6 +24,7 @@
 #include "global-context.hh"
 #include "music-output.hh"
 #include "paper-def.hh"
+#include "paper-score.hh"
 
 LY_DEFINE (ly_make_score, "ly:make-score", 1, 0, 0, (SCM music),
            R"(
@@ -144,3 +145,25 @@ Run @var{score} through @var{layout} (an output definition) scaled to correct
 
   return output;
 }
+
+LY_DEFINE (ly_score_paper_systems, "ly:score-paper-systems", 2, 1, 0,
+           (SCM score, SCM paper, SCM layout),
+           R"(
+Typeset @var{score} as part of a book with output definition @var{paper},
+using @var{layout} if the score has no output definitions of its own, and
+break it into lines.  Return the list of paper systems, or @code{#f} if the
+score does not produce a layout.
+           )")
+{
+  auto *const sc = LY_ASSERT_SMOB (Score, score, 1);
+  auto *const od = LY_ASSERT_SMOB (Output_def, paper, 2);
+  Output_def *layout_def = nullptr;
+  if (!SCM_UNBNDP (layout) && scm_is_true (layout))
+    layout_def = LY_ASSERT_SMOB (Output_def, layout, 3);
+
+  for (SCM s = sc->book_rendering (od, layout_def); scm_is_pair (s);
+       s = scm_cdr (s))
+    if (auto *pscore = unsmob<Paper_score> (scm_car (s)))
+      return scm_vector_to_list (pscore->get_paper_systems ());
+  return SCM_BOOL_F;
+}
@@ -70,6 +70,7 @@ protected:
 
 public:
   TRANSLATOR_DECLARATIONS (Script_engraver);
+  bool needs_idle_timesteps () const override { return false; }
 };
 
 Script_engraver::Script_engraver (Context *c)
@@ -24,13 +24,16 @@
 #include "dimensions.hh"
 #include "international.hh"
 #include "paper-column.hh"
+#include "program-option.hh"
 #include "simple-spacer.hh"
 #include "spaceable-grob.hh"
 #include "spring.hh"
 #include "warn.hh"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <thread>
 #include <vector>
 
 /*
@@ -430,6 +433,19 @@ get_column_description (std::vector<Paper_column *> const &cols,
   return description;
 }
 
+/* The number of threads to use for computing line forces, as given by
+   the `line-breaking-thread-count' option.  Zero means one thread per
+   processor. */
+static vsize
+line_breaking_thread_count ()
+{
+  int count = from_scm<int> (
+    ly_get_option (ly_symbol2scm ("line-breaking-thread-count")), 1);
+  if (count > 0)
+    return count;
+  return std::max (std::thread::hardware_concurrency (), 1u);
+}
+
 /* returns a vector of dimensions breaks.size () * breaks.size ()
 
    Compute the forces for all (start, end) combinations where
@@ -465,55 +481,98 @@ get_line_forces (std::vector<Paper_column *> const &columns, Real line_len,
   breaks.push_back (cols.size ());
   force.resize (breaks.size () * breaks.size (), infinity_f);
 
+  /* Everything that looks at grobs happens before this point.  The rows
+     of the force matrix only use the extracted column descriptions, so
+     they can be filled in parallel. */
+  std::vector<Column_description> start_cols (breaks.size ());
   for (vsize b = 0; b + 1 < breaks.size (); b++)
-    {
-      cols[breaks[b]] = get_column_description (non_loose, breaks[b], true);
-      vsize st = breaks[b];
-
-      for (vsize c = b + 1; c < breaks.size (); c++)
-        {
-          vsize end = breaks[c];
-          Simple_spacer spacer;
-
-          for (vsize i = breaks[b]; i < end - 1; i++)
-            spacer.add_spring (cols[i].spring_);
-          spacer.add_spring (cols[end - 1].end_spring_);
-
-          for (vsize i = breaks[b]; i < end; i++)
-            {
-              for (vsize right = 0; right < cols[i].rods_.size (); right++)
-                if (cols[i].rods_[right].right_ < end)
-                  spacer.add_rod (i - st, cols[i].rods_[right].right_ - st,
-                                  cols[i].rods_[right].dist_);
-              for (vsize right = 0; right < cols[i].end_rods_.size (); right++)
-                if (cols[i].end_rods_[right].right_ == end)
-                  spacer.add_rod (i - st, end - st,
-                                  cols[i].end_rods_[right].dist_);
-              if (!cols[i].keep_inside_line_.is_empty ())
-                {
-                  spacer.add_rod (i - st, end - st,
-                                  cols[i].keep_inside_line_[RIGHT]);
-                  spacer.add_rod (0, i - st, -cols[i].keep_inside_line_[LEFT]);
-                }
-            }
-          Simple_spacer::Solution sol
-            = spacer.solve ((b == 0) ? line_len - indent : line_len, ragged);
-          force[b * breaks.size () + c]
-            = spacer.force_penalty (line_len, sol.force_, ragged);
-
-          if (!sol.fits_)
-            {
-              if (c == b + 1)
-                force[b * breaks.size () + c] = -200000;
-              else
-                force[b * breaks.size () + c] = infinity_f;
-              break;
-            }
-          if (end < cols.size ()
-              && scm_is_eq (cols[end].break_permission_, force_break))
+    start_cols[b] = get_column_description (non_loose, breaks[b], true);
+
+  auto fill_row = [&] (vsize b) {
+    vsize st = breaks[b];
+    auto col = [&] (vsize i) -> Column_description const & {
+      return (i == st) ? start_cols[b] : cols[i];
+    };
+
+    for (vsize c = b + 1; c < breaks.size (); c++)
+      {
+        vsize end = breaks[c];
+        Simple_spacer spacer;
+
+        for (vsize i = st; i < end - 1; i++)
+          spacer.add_spring (col (i).spring_);
+        spacer.add_spring (col (end - 1).end_spring_);
+
+        for (vsize i = st; i < end; i++)
+          {
+            Column_description const &desc = col (i);
+            for (vsize right = 0; right < desc.rods_.size (); right++)
+              if (desc.rods_[right].right_ < end)
+                spacer.add_rod (i - st, desc.rods_[right].right_ - st,
+                                desc.rods_[right].dist_);
+            for (vsize right = 0; right < desc.end_rods_.size (); right++)
+              if (desc.end_rods_[right].right_ == end)
+                spacer.add_rod (i - st, end - st, desc.end_rods_[right].dist_);
+            if (!desc.keep_inside_line_.is_empty ())
+              {
+                spacer.add_rod (i - st, end - st,
+                                desc.keep_inside_line_[RIGHT]);
+                spacer.add_rod (0, i - st, -desc.keep_inside_line_[LEFT]);
+              }
+          }
+        Simple_spacer::Solution sol
+          = spacer.solve ((b == 0) ? line_len - indent : line_len, ragged);
+        force[b * breaks.size () + c]
+          = spacer.force_penalty (line_len, sol.force_, ragged);
+
+        if (!sol.fits_)
+          {
+            if (c == b + 1)
+              force[b * breaks.size () + c] = -200000;
+            else
+              force[b * breaks.size () + c] = infinity_f;
             break;
-        }
+          }
+        if (end < cols.size ()
+            && scm_is_eq (cols[end].break_permission_, force_break))
+          break;
+      }
+  };
+
+  vsize row_count = breaks.size () - 1;
+  vsize thread_count = std::min (line_breaking_thread_count (), row_count);
+  if (thread_count <= 1)
+    {
+      for (vsize b = 0; b < row_count; b++)
+        fill_row (b);
     }
+  else
+    {
+      /* Rows get shorter towards the end, so hand them out one at a
+         time instead of in fixed blocks.  Programming errors from the
+         springs are collected per row and reported in row order once all
+         threads are done, as the serial code would report them. */
+      std::atomic<vsize> next_row (0);
+      std::vector<Programming_errors> row_errors (row_count);
+      auto worker = [&] () {
+        for (vsize b; (b = next_row++) < row_count;)
+          {
+            Programming_error_collector collector (&row_errors[b]);
+            fill_row (b);
+          }
+      };
+
+      std::vector<std::thread> threads;
+      for (vsize t = 1; t < thread_count; t++)
+        threads.emplace_back (worker);
+      worker ();
+      for (auto &t : threads)
+        t.join ();
+
+      for (auto const &errors : row_errors)
+        report_programming_errors (errors);
+    }
+
   return force;
 }
 
@@ -21,6 +21,7 @@
 #include "skyline-pair.hh"
 #include "international.hh"
 
+#include <algorithm>
 #include <deque>
 #include <cstdio>
 
@@ -452,29 +453,78 @@ Skyline::Skyline (std::vector<Drul_array<Offset>> const &segments,
   buildings_ = internal_build_skyline (&buildings);
 }
 
+static std::vector<Placed_skyline>
+unplaced_skylines (std::vector<Skyline_pair> const &skypairs, Direction sky)
+{
+  std::vector<Placed_skyline> ret;
+  ret.reserve (skypairs.size ());
+  for (auto const &skyp : skypairs)
+    ret.push_back ({&skyp[sky], 0.0, 0.0});
+  return ret;
+}
+
 Skyline::Skyline (std::vector<Skyline_pair> const &skypairs, Direction sky)
+  : Skyline (unplaced_skylines (skypairs, sky), sky)
+{
+}
+
+/*
+  Merge several skylines, each raised and shifted by its own offset.
+
+  Accumulating the inputs into one skyline rewrites the accumulated
+  buildings once per input, which is quadratic in the number of inputs.
+  Instead, keep the partial results in a heap ordered by size and
+  always merge the two smallest, so that every building is copied
+  O(log k) times for k inputs.  The offsets are applied while copying
+  the inputs, so the callers need not raise and shift them first.
+*/
+Skyline::Skyline (std::vector<Placed_skyline> const &skylines, Direction sky)
 {
   sky_ = sky;
 
-  std::deque<Skyline> partials;
-  for (vsize i = 0; i < skypairs.size (); i++)
-    partials.push_back (Skyline ((skypairs[i])[sky]));
+  auto larger = [] (std::vector<Building> const &a,
+                    std::vector<Building> const &b) {
+    return a.size () > b.size ();
+  };
 
-  while (partials.size () > 1)
+  std::vector<std::vector<Building>> heap;
+  heap.reserve (skylines.size ());
+  for (auto const &placed : skylines)
     {
-      Skyline one = partials.front ();
-      partials.pop_front ();
-      Skyline two = partials.front ();
-      partials.pop_front ();
+      Skyline const *const s = placed.skyline_;
+      assert (s->sky_ == sky);
+      if (s->is_empty ())
+        continue;
+
+      heap.push_back (s->buildings_);
+      for (auto &b : heap.back ())
+        {
+          b.x_[LEFT] += placed.shift_;
+          b.x_[RIGHT] += placed.shift_;
+          b.y_intercept_ += sky * placed.raise_ - placed.shift_ * b.slope_;
+        }
+    }
+  std::make_heap (heap.begin (), heap.end (), larger);
 
-      one.merge (two);
-      partials.push_back (one);
+  while (heap.size () > 1)
+    {
+      std::pop_heap (heap.begin (), heap.end (), larger);
+      std::vector<Building> one (std::move (heap.back ()));
+      heap.pop_back ();
+      std::pop_heap (heap.begin (), heap.end (), larger);
+      std::vector<Building> two (std::move (heap.back ()));
+      heap.pop_back ();
+
+      std::vector<Building> merged;
+      internal_merge_skyline (&one, &two, &merged);
+      heap.push_back (std::move (merged));
+      std::push_heap (heap.begin (), heap.end (), larger);
     }
 
-  if (partials.size ())
-    buildings_.swap (partials.front ().buildings_);
+  if (heap.empty ())
+    empty_skyline (&buildings_);
   else
-    buildings_.clear ();
+    buildings_.swap (heap.front ());
 }
 
 Skyline::Skyline (Box const &b, Axis horizon_axis, Direction sky)
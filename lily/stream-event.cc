@@ -97,6 +97,7 @@ Stream_event::make_transposable ()
         mutable_property_alist_
           = scm_acons (prop, music_deep_copy (val), mutable_property_alist_);
     }
+  forget_hot_properties ();
 }
 
 void
@@ -0,0 +1,758 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2023 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  A native writer for the SVG backend.  It produces the same elements
+  as the stencil outputters in scm/output-svg.scm, but formats them into
+  a single buffer that is written to the port in large chunks.  Glyph
+  outlines are read from the SVG fonts once per run.  A first pass over
+  the stencil counts the glyphs; those that occur once are written as
+  paths like output-svg.scm does, those that occur more than once are
+  emitted as a path in <defs> the first time and as <use> elements
+  referring to that path every time.  The ids of these paths include a
+  hash of the output file name, so that pages inlined into one document
+  do not clash.
+
+  Expressions that are rare or depend on state of the Scheme backend
+  (text, links, point-and-click, images, ...) are passed on to the
+  Scheme functions, as are malformed ones, so that they get the same
+  warnings and errors.
+*/
+
+#include "international.hh"
+#include "lily-imports.hh"
+#include "main.hh"
+#include "paper-outputter.hh"
+#include "source-file.hh"
+#include "stencil.hh"
+#include "stencil-interpret.hh"
+#include "string-convert.hh"
+#include "warn.hh"
+
+#include <cctype>
+#include <cstdint>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+struct Svg_glyph
+{
+  bool has_path_ = false;
+  std::string path_;
+};
+
+// The glyphs of an SVG font, by name.
+using Svg_font = std::unordered_map<std::string, Svg_glyph>;
+
+// Find the value of attribute NAME in ELEMENT.
+bool
+find_attribute (std::string const &element, char const *name,
+                std::string *value)
+{
+  std::string key = std::string (" ") + name + "=\"";
+  size_t pos = 0;
+  while ((pos = element.find (name, pos)) != std::string::npos)
+    {
+      // NAME must follow white space and be followed by ="
+      size_t end = pos + key.length () - 1;
+      if (pos > 0 && isspace (static_cast<unsigned char> (element[pos - 1]))
+          && element.compare (pos, key.length () - 1, key, 1) == 0)
+        {
+          size_t close = element.find ('"', end);
+          if (close == std::string::npos)
+            return false;
+          *value = element.substr (end, close - end);
+          return true;
+        }
+      pos++;
+    }
+  return false;
+}
+
+/*
+  Read the <glyph> elements inside <defs> of FILE_NAME.  As in
+  output-svg.scm, only the first glyph of a given name counts.
+*/
+Svg_font
+read_svg_font (std::string const &file_name)
+{
+  Svg_font font;
+  std::string contents = gulp_file (file_name, 0);
+  size_t start = contents.find ("<defs>");
+  size_t end = contents.find ("</defs>");
+  if (start == std::string::npos || end == std::string::npos)
+    return font;
+
+  for (size_t pos = contents.find ("<glyph", start); pos < end;
+       pos = contents.find ("<glyph", pos))
+    {
+      size_t close = contents.find ("/>", pos);
+      if (close == std::string::npos)
+        break;
+      std::string element = contents.substr (pos, close - pos);
+      pos = close;
+      if (element.length () <= 6
+          || !isspace (static_cast<unsigned char> (element[6])))
+        continue;
+
+      std::string name;
+      if (!find_attribute (element, "glyph-name", &name)
+          || font.count (name))
+        continue;
+      Svg_glyph &glyph = font[name];
+      glyph.has_path_ = find_attribute (element, "d", &glyph.path_);
+    }
+  return font;
+}
+
+// SVG fonts by file name, read when first needed.
+std::unordered_map<std::string, std::unique_ptr<Svg_font>> svg_fonts;
+
+// The SVG font for the font named NAME_STYLE, or nullptr.
+Svg_font const *
+find_svg_font (std::string const &name_style)
+{
+  std::string file_name = global_path.find (name_style + ".svg");
+  if (file_name.empty ())
+    return nullptr;
+  auto &font = svg_fonts[file_name];
+  if (!font)
+    font.reset (new Svg_font (read_svg_font (file_name)));
+  return font.get ();
+}
+
+// Whether S is a list of at least N elements.
+bool
+has_length_at_least (SCM s, int n)
+{
+  for (; n > 0; n--, s = scm_cdr (s))
+    if (!scm_is_pair (s))
+      return false;
+  return true;
+}
+
+// The FNV-1a hash of S, which unlike std::hash is the same everywhere.
+uint32_t
+fnv1a_hash (std::string const &s)
+{
+  uint32_t hash = 2166136261u;
+  for (unsigned char c : s)
+    {
+      hash ^= c;
+      hash *= 16777619u;
+    }
+  return hash;
+}
+
+class Svg_writer : public Stencil_sink
+{
+public:
+  Svg_writer (Paper_outputter *outputter, SCM unit_length,
+              std::string const &file_name)
+    : outputter_ (outputter),
+      unit_length_ (unit_length),
+      id_prefix_ (String_convert::form_string ("glyph-%08x-",
+                                               fnv1a_hash (file_name)))
+  {
+  }
+  Svg_writer (Svg_writer const &) = delete;
+  Svg_writer &operator= (Svg_writer const &) = delete;
+
+  SCM output (SCM expr) override;
+  void flush ();
+  // Only count the glyphs in the expressions that follow.
+  void set_counting (bool counting) { counting_ = counting; }
+
+private:
+  // A font smob used by named-glyph, with its glyphs.
+  struct Named_font
+  {
+    Svg_font const *font_ = nullptr;
+    // "scale(S, -S)" for its glyphs
+    std::string transform_;
+  };
+
+  Paper_outputter *outputter_;
+  SCM unit_length_;
+  std::string buf_;
+  std::unordered_map<SCM, Named_font> named_fonts_;
+  std::string id_prefix_;
+  bool counting_ = false;
+  // How often each glyph occurs in the stencil.
+  std::unordered_map<Svg_glyph const *, int> glyph_counts_;
+  // Ids of the glyphs written into <defs> so far.
+  std::unordered_map<Svg_glyph const *, std::string> glyph_ids_;
+
+  SCM fall_back (SCM expr);
+
+  void number (double);
+  void number (SCM, int factor = 1);
+  template <class T>
+  std::string formatted (T x);
+  void attribute (char const *name, char const *value);
+  void attribute (char const *name, SCM x);
+  void fill_attribute (SCM filled);
+  void round_stroke_attributes ();
+  std::string scale_transform (SCM size);
+  void use_glyph (Svg_glyph const &, std::string const &transform);
+
+  void circle (SCM radius, SCM thick, SCM filled);
+  void draw_line (SCM thick, SCM x1, SCM y1, SCM x2, SCM y2);
+  void ellipse (SCM x_radius, SCM y_radius, SCM thick, SCM filled);
+  bool glyph_string (SCM font_name, SCM size, SCM glyphs);
+  bool named_glyph (SCM font, SCM name);
+  bool path (SCM thick, SCM commands, SCM cap, SCM join, SCM filled);
+  bool polygon (SCM coords, SCM blot, SCM filled);
+  void round_filled_box (SCM left, SCM right, SCM bottom, SCM top,
+                         SCM blot);
+  void open_group (char const *prefix, SCM a, int fa, SCM b, int fb,
+                   SCM c = SCM_UNDEFINED, int fc = 1);
+};
+
+void
+Svg_writer::flush ()
+{
+  if (!buf_.empty ())
+    {
+      scm_c_write (outputter_->file (), buf_.data (), buf_.size ());
+      buf_.clear ();
+    }
+}
+
+SCM
+Svg_writer::fall_back (SCM expr)
+{
+  flush ();
+  return outputter_->output_scheme (expr);
+}
+
+// As format_single_argument () does for ly:format's ~4f.
+void
+Svg_writer::number (double x)
+{
+  if (!std::isfinite (x))
+    {
+      warning (_ ("Found infinity or nan in output.  Substituting 0.0"));
+      buf_ += "0.0";
+    }
+  else
+    String_convert::append_fixed (&buf_, x, 4);
+}
+
+/*
+  Append FACTOR * X as output-svg.scm formats it with ly:format: exact
+  integers without decimals.  Exact values are multiplied in Scheme to
+  stay exact.
+*/
+void
+Svg_writer::number (SCM x, int factor)
+{
+  if (scm_is_true (scm_exact_p (x)))
+    {
+      if (factor != 1)
+        x = scm_product (x, to_scm (factor));
+      if (scm_is_integer (x))
+        {
+          buf_ += std::to_string (from_scm<int> (x));
+          return;
+        }
+      factor = 1;
+    }
+  number (from_scm<double> (x) * factor);
+}
+
+template <class T>
+std::string
+Svg_writer::formatted (T x)
+{
+  std::string saved;
+  std::swap (saved, buf_);
+  number (x);
+  std::swap (saved, buf_);
+  return saved;
+}
+
+void
+Svg_writer::attribute (char const *name, char const *value)
+{
+  buf_ += ' ';
+  buf_ += name;
+  buf_ += "=\"";
+  buf_ += value;
+  buf_ += '"';
+}
+
+void
+Svg_writer::attribute (char const *name, SCM x)
+{
+  buf_ += ' ';
+  buf_ += name;
+  buf_ += "=\"";
+  number (x);
+  buf_ += '"';
+}
+
+void
+Svg_writer::fill_attribute (SCM filled)
+{
+  attribute ("fill", scm_is_true (filled) ? "currentColor" : "none");
+}
+
+void
+Svg_writer::round_stroke_attributes ()
+{
+  attribute ("stroke-linejoin", "round");
+  attribute ("stroke-linecap", "round");
+}
+
+/*
+  PREFIX, then FA * A, FB * B and FC * C separated by commas: the
+  opening <g> of settranslation, setrotation and setscale.
+*/
+void
+Svg_writer::open_group (char const *prefix, SCM a, int fa, SCM b, int fb,
+                        SCM c, int fc)
+{
+  buf_ += "<g ";
+  buf_ += prefix;
+  number (a, fa);
+  buf_ += ", ";
+  number (b, fb);
+  if (!SCM_UNBNDP (c))
+    {
+      buf_ += ", ";
+      number (c, fc);
+    }
+  buf_ += ")\">\n";
+}
+
+void
+Svg_writer::circle (SCM radius, SCM thick, SCM filled)
+{
+  buf_ += "<circle";
+  round_stroke_attributes ();
+  fill_attribute (filled);
+  attribute ("stroke", "currentColor");
+  attribute ("stroke-width", thick);
+  attribute ("r", radius);
+  buf_ += "/>\n";
+}
+
+void
+Svg_writer::draw_line (SCM thick, SCM x1, SCM y1, SCM x2, SCM y2)
+{
+  buf_ += "<line";
+  round_stroke_attributes ();
+  attribute ("stroke-width", thick);
+  attribute ("stroke", "currentColor");
+  attribute ("x1", x1);
+  buf_ += " y1=\"";
+  number (y1, -1);
+  buf_ += '"';
+  attribute ("x2", x2);
+  buf_ += " y2=\"";
+  number (y2, -1);
+  buf_ += "\"/>\n";
+}
+
+void
+Svg_writer::ellipse (SCM x_radius, SCM y_radius, SCM thick, SCM filled)
+{
+  buf_ += "<ellipse";
+  round_stroke_attributes ();
+  fill_attribute (filled);
+  attribute ("stroke", "currentColor");
+  attribute ("stroke-width", thick);
+  attribute ("rx", x_radius);
+  attribute ("ry", y_radius);
+  buf_ += "/>\n";
+}
+
+bool
+Svg_writer::polygon (SCM coords, SCM blot, SCM filled)
+{
+  if (!scm_is_true (scm_list_p (coords))
+      || scm_ilength (coords) % 2)
+    return false;
+
+  buf_ += "<polygon";
+  round_stroke_attributes ();
+  attribute ("stroke-width", blot);
+  fill_attribute (filled);
+  attribute ("stroke", "currentColor");
+  buf_ += " points=\"";
+  for (SCM s = coords; scm_is_pair (s); s = scm_cddr (s))
+    {
+      if (!scm_is_eq (s, coords))
+        buf_ += ' ';
+      number (scm_car (s));
+      buf_ += ' ';
+      number (scm_cadr (s), -1);
+    }
+  buf_ += "\"/>\n";
+  return true;
+}
+
+void
+Svg_writer::round_filled_box (SCM left, SCM right, SCM bottom, SCM top,
+                              SCM blot)
+{
+  // Only the sum of two exact numbers stays exact.
+  auto sum = [this] (SCM a, SCM b) {
+    if (scm_is_true (scm_exact_p (a)) && scm_is_true (scm_exact_p (b)))
+      number (scm_sum (a, b));
+    else
+      number (from_scm<double> (a) + from_scm<double> (b));
+  };
+
+  buf_ += "<rect x=\"";
+  number (left, -1);
+  buf_ += "\" y=\"";
+  number (top, -1);
+  buf_ += "\" width=\"";
+  sum (left, right);
+  buf_ += "\" height=\"";
+  sum (bottom, top);
+  buf_ += "\" ry=\"";
+  if (scm_is_true (scm_exact_p (blot)))
+    number (scm_divide (blot, to_scm (2)));
+  else
+    number (from_scm<double> (blot) / 2);
+  buf_ += '"';
+  attribute ("fill", "currentColor");
+  buf_ += "/>\n";
+}
+
+bool
+Svg_writer::path (SCM thick, SCM commands, SCM cap, SCM join, SCM filled)
+{
+  auto style = [] (SCM s, char const *a, char const *b, char const *c) {
+    if (SCM_UNBNDP (s))
+      return std::string ("round");
+    if (!scm_is_symbol (s))
+      return std::string ();
+    std::string name = ly_symbol2string (s);
+    return (name == a || name == b || name == c) ? name : std::string ();
+  };
+  // Unknown styles are warned about by the Scheme function.
+  std::string cap_style = style (cap, "butt", "round", "square");
+  std::string join_style = style (join, "miter", "round", "bevel");
+  if (cap_style.empty () || join_style.empty ())
+    return false;
+
+  std::string d;
+  std::swap (d, buf_);
+  for (SCM s = commands; scm_is_pair (s);)
+    {
+      SCM head = scm_car (s);
+      s = scm_cdr (s);
+      char op = 0;
+      int arity = 2;
+      if (scm_is_eq (head, ly_symbol2scm ("rmoveto")))
+        op = 'm';
+      else if (scm_is_eq (head, ly_symbol2scm ("rlineto")))
+        op = 'l';
+      else if (scm_is_eq (head, ly_symbol2scm ("lineto")))
+        op = 'L';
+      else if (scm_is_eq (head, ly_symbol2scm ("moveto")))
+        op = 'M';
+      else if (scm_is_eq (head, ly_symbol2scm ("rcurveto")))
+        op = 'c', arity = 6;
+      else if (scm_is_eq (head, ly_symbol2scm ("curveto")))
+        op = 'C', arity = 6;
+      else if (scm_is_eq (head, ly_symbol2scm ("closepath")))
+        op = 'z', arity = 0;
+
+      if (!op || !has_length_at_least (s, arity))
+        {
+          std::swap (d, buf_);
+          return false;
+        }
+      buf_ += op;
+      for (int i = 0; i < arity; i += 2)
+        {
+          if (i)
+            buf_ += ' ';
+          number (scm_car (s));
+          buf_ += ' ';
+          number (scm_cadr (s), -1);
+          s = scm_cddr (s);
+        }
+    }
+  std::swap (d, buf_);
+
+  buf_ += "<path";
+  attribute ("stroke-width", thick);
+  attribute ("stroke-linejoin", join_style.c_str ());
+  attribute ("stroke-linecap", cap_style.c_str ());
+  attribute ("stroke", "currentColor");
+  fill_attribute (SCM_UNBNDP (filled) ? SCM_BOOL_F : filled);
+  attribute ("d", d.c_str ());
+  buf_ += "/>\n";
+  return true;
+}
+
+// "scale(S, -S)" for glyphs of SIZE, as dump-path writes it.
+std::string
+Svg_writer::scale_transform (SCM size)
+{
+  std::string scale = formatted (scm_divide (size, to_scm (1000)));
+  return "scale(" + scale + ", -" + scale + ")";
+}
+
+void
+Svg_writer::use_glyph (Svg_glyph const &glyph, std::string const &transform)
+{
+  auto count = glyph_counts_.find (&glyph);
+  if (count == glyph_counts_.end () || count->second < 2)
+    {
+      // As dump-path writes it.
+      buf_ += "<path";
+      attribute ("transform", transform.c_str ());
+      attribute ("d", glyph.path_.c_str ());
+      attribute ("fill", "currentColor");
+      buf_ += "/>\n";
+      return;
+    }
+
+  std::string &id = glyph_ids_[&glyph];
+  if (id.empty ())
+    {
+      id = id_prefix_ + std::to_string (glyph_ids_.size ());
+      buf_ += "<defs><path id=\"";
+      buf_ += id;
+      buf_ += "\" d=\"";
+      buf_ += glyph.path_;
+      buf_ += "\"/></defs>\n";
+    }
+  buf_ += "<use xlink:href=\"#";
+  buf_ += id;
+  buf_ += '"';
+  attribute ("transform", transform.c_str ());
+  attribute ("fill", "currentColor");
+  buf_ += "/>\n";
+}
+
+bool
+Svg_writer::named_glyph (SCM font, SCM name)
+{
+  if (scm_is_string (font) || !scm_is_string (name))
+    return false;
+
+  auto it = named_fonts_.find (font);
+  if (it == named_fonts_.end ())
+    {
+      Named_font nf;
+      nf.font_ = find_svg_font (ly_scm2string (Lily::font_name_style (font)));
+      if (nf.font_)
+        nf.transform_ = scale_transform (
+          Lily::modified_font_metric_font_scaling (font));
+      it = named_fonts_.emplace (font, nf).first;
+    }
+  Named_font const &nf = it->second;
+  if (!nf.font_)
+    return false;
+
+  auto glyph = nf.font_->find (ly_scm2string (name));
+  if (glyph == nf.font_->end ())
+    return false;
+  if (counting_)
+    glyph_counts_[&glyph->second]++;
+  else if (glyph->second.has_path_)
+    use_glyph (glyph->second, nf.transform_);
+  return true;
+}
+
+bool
+Svg_writer::glyph_string (SCM font_name, SCM size, SCM glyphs)
+{
+  if (!scm_is_string (font_name) || !scm_is_pair (glyphs))
+    return false;
+  Svg_font const *font = find_svg_font (
+    String_convert::to_lower (ly_scm2string (font_name)));
+  if (!font)
+    return false;
+
+  // Look up all glyphs before writing anything.
+  std::vector<Svg_glyph const *> found;
+  for (SCM s = glyphs; scm_is_pair (s); s = scm_cdr (s))
+    {
+      SCM entry = scm_car (s);
+      if (scm_ilength (entry) < 5)
+        return false;
+      SCM name = scm_car (scm_last_pair (entry));
+      if (!scm_is_string (name))
+        return false;
+      auto glyph = font->find (ly_scm2string (name));
+      if (glyph == font->end ())
+        return false;
+      found.push_back (&glyph->second);
+    }
+
+  if (counting_)
+    {
+      for (auto *glyph : found)
+        glyph_counts_[glyph]++;
+      return true;
+    }
+
+  std::string const scale = scale_transform (scm_divide (size, unit_length_));
+  bool const grouped = found.size () > 1;
+  if (grouped)
+    buf_ += "<g>\n";
+
+  // The cumulative advance of the glyphs so far.
+  double advance = 0.0;
+  vsize i = 0;
+  for (SCM s = glyphs; scm_is_pair (s); s = scm_cdr (s), i++)
+    {
+      SCM entry = scm_car (s);
+      if (grouped && i)
+        buf_ += '\n';
+      if (found[i]->has_path_)
+        {
+          double x = from_scm<double> (scm_caddr (entry)) + advance;
+          SCM y = scm_cadddr (entry);
+          if (x != 0 || from_scm<double> (y) != 0)
+            use_glyph (*found[i], "translate(" + formatted (x) + ", "
+                                    + formatted (y) + ") " + scale);
+          else
+            use_glyph (*found[i], scale);
+        }
+      advance += from_scm<double> (scm_car (entry));
+    }
+
+  if (grouped)
+    buf_ += "</g>\n";
+  return true;
+}
+
+SCM
+Svg_writer::output (SCM expr)
+{
+  SCM head = scm_car (expr);
+
+  if (counting_)
+    {
+      // Nothing is written, and nothing passed to the Scheme backend.
+      SCM args = scm_cdr (expr);
+      if (scm_is_eq (head, ly_symbol2scm ("named-glyph"))
+          && scm_ilength (args) == 2)
+        named_glyph (scm_car (args), scm_cadr (args));
+      else if (scm_is_eq (head, ly_symbol2scm ("glyph-string"))
+               && has_length_at_least (args, 5))
+        glyph_string (scm_cadr (args), scm_caddr (args),
+                      scm_list_ref (args, to_scm (4)));
+      return SCM_UNSPECIFIED;
+    }
+
+  const int N = 5;
+  SCM arg[N];
+  int argc = 0;
+  for (SCM s = scm_cdr (expr); scm_is_pair (s) && argc < N; s = scm_cdr (s))
+    arg[argc++] = scm_car (s);
+  for (int i = argc; i < N; i++)
+    arg[i] = SCM_UNDEFINED;
+
+  bool done = true;
+  if (scm_is_eq (head, ly_symbol2scm ("settranslation")) && argc == 2)
+    open_group ("transform=\"translate(", arg[0], 1, arg[1], -1);
+  else if (scm_is_eq (head, ly_symbol2scm ("resettranslation"))
+           || scm_is_eq (head, ly_symbol2scm ("resetcolor"))
+           || scm_is_eq (head, ly_symbol2scm ("resetrotation"))
+           || scm_is_eq (head, ly_symbol2scm ("resetscale"))
+           || scm_is_eq (head, ly_symbol2scm ("end-group-node")))
+    buf_ += "</g>\n";
+  else if (scm_is_eq (head, ly_symbol2scm ("named-glyph")) && argc == 2)
+    done = named_glyph (arg[0], arg[1]);
+  else if (scm_is_eq (head, ly_symbol2scm ("glyph-string")) && argc == N)
+    // (glyph-string pango-font font-name size cid? glyphs ...)
+    done = glyph_string (arg[1], arg[2], arg[4]);
+  else if (scm_is_eq (head, ly_symbol2scm ("round-filled-box")) && argc == 5)
+    round_filled_box (arg[0], arg[1], arg[2], arg[3], arg[4]);
+  else if (scm_is_eq (head, ly_symbol2scm ("draw-line")) && argc == 5)
+    draw_line (arg[0], arg[1], arg[2], arg[3], arg[4]);
+  else if (scm_is_eq (head, ly_symbol2scm ("polygon")) && argc == 3)
+    done = polygon (arg[0], arg[1], arg[2]);
+  else if (scm_is_eq (head, ly_symbol2scm ("path")) && argc >= 2)
+    done = path (arg[0], arg[1], arg[2], arg[3], arg[4]);
+  else if (scm_is_eq (head, ly_symbol2scm ("circle")) && argc == 3)
+    circle (arg[0], arg[1], arg[2]);
+  else if (scm_is_eq (head, ly_symbol2scm ("ellipse")) && argc == 4)
+    ellipse (arg[0], arg[1], arg[2], arg[3]);
+  else if (scm_is_eq (head, ly_symbol2scm ("setcolor")) && argc == 4)
+    {
+      buf_ += "<g color=\"rgba(";
+      for (int i = 0; i < 4; i++)
+        {
+          if (i)
+            buf_ += ", ";
+          number (arg[i], 100);
+          buf_ += '%';
+        }
+      buf_ += ")\">\n";
+    }
+  else if (scm_is_eq (head, ly_symbol2scm ("setrotation")) && argc == 3)
+    open_group ("transform=\"rotate(", arg[0], -1, arg[1], 1, arg[2], -1);
+  else if (scm_is_eq (head, ly_symbol2scm ("setscale")) && argc == 2)
+    open_group ("transform=\"scale(", arg[0], 1, arg[1], 1);
+  else if (scm_is_eq (head, ly_symbol2scm ("embedded-svg")) && argc == 1
+           && scm_is_string (arg[0]))
+    buf_ += ly_scm2string (arg[0]);
+  else
+    done = false;
+
+  if (!done)
+    return fall_back (expr);
+
+  if (buf_.size () > (1 << 16))
+    flush ();
+  return SCM_UNSPECIFIED;
+}
+} // namespace
+
+LY_DEFINE (ly_svg_dump_stencil, "ly:svg-dump-stencil", 4, 0, 0,
+           (SCM outputter, SCM stencil, SCM unit_length, SCM file_name),
+           R"(
+Dump @var{stencil} onto @var{outputter} as SVG, using the SVG fonts for
+glyphs, which are scaled by the output scale @var{unit-length}.  The result is
+equivalent to dumping the stencil with the stencil outputters of the SVG
+backend, except that glyphs occurring more than once refer to a single path
+through @code{<use>} elements.  The ids of these paths are derived from
+@var{file-name}, the name of the output file.  Expressions that are not handled
+natively are passed to the stencil outputters of @var{outputter}.
+           )")
+{
+  auto *const po = LY_ASSERT_SMOB (Paper_outputter, outputter, 1);
+  auto *const st = LY_ASSERT_SMOB (const Stencil, stencil, 2);
+  LY_ASSERT_TYPE (scm_is_real, unit_length, 3);
+  LY_ASSERT_TYPE (scm_is_string, file_name, 4);
+
+  Svg_writer writer (po, unit_length, ly_scm2string (file_name));
+  writer.set_counting (true);
+  interpret_stencil_expression (st->expr (), &writer, Offset (0, 0));
+  writer.set_counting (false);
+  interpret_stencil_expression (st->expr (), &writer, Offset (0, 0));
+  writer.flush ();
+  return SCM_UNSPECIFIED;
+}
@@ -34,6 +34,7 @@
 #include "paper-column.hh"
 #include "paper-score.hh"
 #include "paper-system.hh"
+#include "phase-span.hh"
 #include "pointer-group-interface.hh"
 #include "protection-pool.hh"
 #include "skyline-pair.hh"
@@ -513,6 +514,8 @@ System::add_column (Paper_column *p)
 void
 System::pre_processing ()
 {
+  Phase_span span ("pre-processing");
+
   /*
     Each breakable Item calls back to this System to append two clones of
     itself (for before and after a break) to the vector.  We stop after
@@ -552,6 +555,8 @@ System::pre_processing ()
 void
 System::post_processing ()
 {
+  Phase_span span ("post-processing");
+
   Interval iv (extent (this, Y_AXIS));
   if (iv.is_empty ())
     programming_error ("system with empty extent");
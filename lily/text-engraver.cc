@@ -39,6 +39,7 @@ class Text_engraver : public Engraver
 
 public:
   TRANSLATOR_DECLARATIONS (Text_engraver);
+  bool needs_idle_timesteps () const override { return false; }
 
 protected:
   void stop_translation_timestep ();
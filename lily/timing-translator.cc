@@ -484,7 +484,7 @@ Timing_translator::start_translation_timestep ()
   // constantly at zero anyway?
 
   set_property (context (), "measurePosition",
-                Moment (mp, now.grace_part_).smobbed_copy ());
+                to_scm (Moment (mp, now.grace_part_)));
   set_property (context (), "measureStartNow", measure_start_now);
 
   // We set whichBar at each timestep because the user manuals used to suggest
@@ -119,6 +119,7 @@ void
 Translator_group::protect_event (SCM ev)
 {
   protected_events_ = scm_cons (ev, protected_events_);
+  active_ = true;
 }
 
 /*
@@ -267,19 +268,38 @@ Translator_group::precompute_method_bindings ()
       for (int i = 0; i < TRANSLATOR_METHOD_PRECOMPUTE_COUNT; i++)
         {
           if (!SCM_UNBNDP (ptrs[i]))
-            precomputed_method_bindings_[i].push_back (
-              Method_instance (ptrs[i], tr));
+            {
+              precomputed_method_bindings_[i].push_back (
+                Method_instance (ptrs[i], tr));
+              if (tr->needs_idle_timesteps ())
+                idle_method_bindings_[i].push_back (
+                  Method_instance (ptrs[i], tr));
+            }
         }
     }
 }
 
+/*
+  Call the precomputed method IDX of our translators.  Events only
+  arrive after START_TRANSLATION_TIMESTEP, so that one is always called
+  for all translators; in the other phases, idle groups skip the
+  translators that do not need idle time steps.
+*/
 void
 Translator_group::precomputed_translator_foreach (
   Translator_precompute_index idx)
 {
-  std::vector<Method_instance> &bindings (precomputed_method_bindings_[idx]);
+  std::vector<Method_instance> &bindings (
+    active_ || idx == START_TRANSLATION_TIMESTEP
+      ? precomputed_method_bindings_[idx]
+      : idle_method_bindings_[idx]);
   for (vsize i = 0; i < bindings.size (); i++)
     bindings[i]();
+
+  // Grobs announced while stopping are acknowledged in the next time
+  // step, which must then run all phases for the translators they reach.
+  if (idx == STOP_TRANSLATION_TIMESTEP)
+    active_ = has_announcements ();
 }
 
 Translator_group::~Translator_group ()
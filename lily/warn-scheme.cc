@@ -178,6 +178,29 @@ Check whether all expected warnings have really been triggered.
   return SCM_UNSPECIFIED;
 }
 
+LY_DEFINE (ly_expected_warnings, "ly:expected-warnings", 0, 0, 0, (),
+           R"(
+Return the list of expected warnings that have not been encountered yet.
+           )")
+{
+  SCM lst = SCM_EOL;
+  for (auto const &msg : get_expected_warnings ())
+    lst = scm_cons (ly_string2scm (msg), lst);
+  return scm_reverse_x (lst, SCM_EOL);
+}
+
+LY_DEFINE (ly_exit_immediately_on_error, "ly:exit-immediately-on-error", 0, 0,
+           0, (),
+           R"(
+Make fatal errors end LilyPond without running exit handlers or flushing
+output buffers.  This is for forked worker processes, which share these with
+their parent.
+           )")
+{
+  exit_immediately_on_error = true;
+  return SCM_UNSPECIFIED;
+}
+
 LY_DEFINE (ly_translate_cpp_warning_scheme, "ly:translate-cpp-warning-scheme",
            1, 0, 0, (SCM str),
            R"(
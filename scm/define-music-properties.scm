@@ -175,8 +175,8 @@ the context.")
 e.g., @code{cue}.")
      (quoted-context-type ,symbol? "The name of the context to
 direct quotes to, e.g., @code{Voice}.")
-     (quoted-events ,vector? "A vector of with @code{moment} and
-@code{event-list} entries.")
+     (quoted-events ,ly:quote-store? "The events of the quoted music, with
+their moments.")
      (quoted-music-clef ,string? "The clef of the voice to quote.")
      (quoted-music-name ,string? "The name of the voice to quote.")
      (quoted-transposition ,ly:pitch? "The pitch used for the quote,
@@ -26,3 +26,59 @@
           (set! contents (ly:gulp-file filename))
           (hash-set! cache-hash-tab filename contents)))
     contents))
+
+;; Converting a font for embedding is expensive and happens again for
+;; every output file.  Keep the results for the rest of the session
+;; and, if the font-cache-dir option is set, on disk.  Disk entries
+;; are named after the checksum of the font file rather than its name,
+;; so they remain valid when fonts move and become unused when fonts
+;; change.
+(define font-conversion-hash-tab (make-hash-table 11))
+
+(define (font-cache-file-name kind file-name font-index)
+  (let ((dir (ly:get-option 'font-cache-dir)))
+    (and (string? dir)
+         (let ((digest (ly:file-digest file-name)))
+           (and digest
+                (format #f "~a/~a-~a-~a-~a"
+                        dir kind digest font-index (lilypond-version)))))))
+
+(define (read-font-cache-file cache-file)
+  (ly:debug (G_ "Reading converted font from `~a'...") cache-file)
+  (call-with-input-file cache-file get-string-all #:encoding "latin1"))
+
+(define (write-font-cache-file cache-file data)
+  (let ((tmp-file (format #f "~a.~a" cache-file (getpid))))
+    (catch 'system-error
+      (lambda ()
+        (if (not (file-exists? (dirname cache-file)))
+            (mkdir (dirname cache-file)))
+        (call-with-output-file tmp-file
+          (lambda (port) (display data port))
+          #:encoding "latin1")
+        ;; Concurrent runs may write the same entry; renaming makes
+        ;; sure that readers only ever see complete files.
+        (rename-file tmp-file cache-file)
+        (ly:debug (G_ "Wrote converted font to `~a'") cache-file))
+      (lambda (key . args)
+        (ly:warning (G_ "cannot write font cache file `~a': ~a")
+                    cache-file
+                    (apply format #f (cadr args) (caddr args)))
+        (if (file-exists? tmp-file)
+            (delete-file tmp-file))))))
+
+(define-public (cached-font-conversion kind convert file-name font-index)
+  "Return @code{(@var{convert} @var{file-name} @var{font-index})}, a
+string, reusing the result of a previous conversion of the same font
+by @var{kind} (a symbol naming the conversion) if possible."
+  (let ((key (list kind file-name font-index)))
+    (or (hash-ref font-conversion-hash-tab key #f)
+        (let* ((cache-file (font-cache-file-name kind file-name font-index))
+               (data (if (and cache-file (file-exists? cache-file))
+                         (read-font-cache-file cache-file)
+                         (let ((data (convert file-name font-index)))
+                           (if cache-file
+                               (write-font-cache-file cache-file data))
+                           data))))
+          (hash-set! font-conversion-hash-tab key data)
+          data))))
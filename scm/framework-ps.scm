@@ -258,7 +258,9 @@
                   (ly:debug (G_ "Embedding CFF font `~a'.") name)
                   (set! font-list
                         (acons name-symbol args-filename-offset font-list))
-                  (ps-embed-cff (ly:otf->cff file-name font-index) name 0))))
+                  (ps-embed-cff (cached-font-conversion
+                                 'cff ly:otf->cff file-name font-index)
+                                name 0))))
           (begin
             (ly:debug (G_ "Initializing embedded CFF font list."))
             (set! font-list '()))))))
@@ -400,7 +402,7 @@
       (cond
        ((eq? font-format 'TrueType)
         ;; TrueType fonts (TTF) and TrueType Collection (TTC)
-        (ly:ttf->pfa file-name font-index))
+        (cached-font-conversion 'pfa ly:ttf->pfa file-name font-index))
        ((eq? font-format 'CFF)
         ;; OpenType/CFF fonts (OTF) and OpenType/CFF Collection (OTC)
         (check-conflict-and-embed-cff name file-name font-index))
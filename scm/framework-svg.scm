@@ -108,7 +108,9 @@ tspan { white-space: pre; }
                      left-x (- top-y) device-width device-height))
     (dump (style-defs-end))
     (eval-svg `(set-unit-length ,unit-length))
-    (ly:outputter-dump-stencil outputter stencil)
+    (if (ly:get-option 'svg-native-writer)
+        (ly:svg-dump-stencil outputter stencil unit-length filename)
+        (ly:outputter-dump-stencil outputter stencil))
     (dump (svg-end))
     (ly:outputter-close outputter)))
 
@@ -218,6 +218,13 @@ session has started."
                   lilypond-declarations)))))
    (current-module))
 
+  ;; Let the score cache identify the procedures of the initialization
+  ;; files by name.
+  (score-cache-save-init-objects
+   (list music-descriptions
+         all-grob-descriptions
+         (map cdddr lilypond-declarations)))
+
   (dump-zombies 0)
   (set! first-session-done? #t))
 
@@ -291,12 +298,22 @@ document.")
     (eps-box-padding #f
                      "Pad left edge of the output EPS bounding box by
 given amount (in mm).")
+    (font-cache-dir #f
+                    "Directory for keeping converted font data
+across runs.")
     (font-export-dir #f
                      "Directory for exporting fonts as PostScript
 files.")
     (font-ps-resdir #f
                     "Build a subset of PostScript resource directory
 for embedding fonts.")
+    (gc-between-files #f
+                      "Collect garbage after processing each input
+file.")
+    (gc-phase-reserve #f
+                      "Before each phase of the compilation, grow
+the heap to have at least the given number of
+megabytes free.")
     (gs-api #t
             "Whether to use the Ghostscript API (read-only
 if not available).")
@@ -325,6 +342,10 @@ to process several files."
     (job-count #f
                "Process in parallel, using the given number of
 jobs.")
+    (line-breaking-thread-count 1
+                                "Compute line-breaking forces using the given
+number of threads.  Zero means one thread per
+processor.")
     (log-file #f
               "If string FOO is given as an argument, redirect
 output to log file `FOO.log'.")
@@ -338,6 +359,9 @@ markup instead.")
                          "midi")
                     "Set the default file extension for MIDI output
 file to given string.")
+    (music-copy-on-write #f
+                         "Share the properties of copied music until
+they are changed.")
     (music-font-encodings #f
                           "Use font encodings and the PostScript `show'
 operator with music fonts.")
@@ -362,6 +386,10 @@ images.")
              "Create preview images also.")
     (print-pages #t
                  "Print pages in the normal way.")
+    (profile-callbacks #f
+                       "Print the time spent in each grob property
+callback, per grob and property, when
+exiting.")
     (profile-property-accesses #f
                                "Keep statistics of get_property() calls."
                                #:internal? #t)
@@ -383,6 +411,20 @@ given value (in dpi).")
     (safe #f
           "Safe mode has been removed; using this option results
 in an error.")
+    (score-cache-dir #f
+                     "Directory for keeping laid-out scores across
+runs, to skip scores whose input is unchanged.
+Changes the output: the systems of scores that
+can be cached keep their line breaks and inner
+spacing as stored, are not stretched to fill
+the page and have no point-and-click links,
+also when they are not read from the cache.")
+    (score-job-count #f
+                     "Typeset the scores of a book in parallel,
+using the given number of jobs.  Changes the
+output: the systems of scores typeset by a job
+are not stretched to fill the page and have no
+point-and-click links.")
     (separate-log-files #f
                         "For input files `FILE1.ly', `FILE2.ly', ...
 output log data to files `FILE1.log',
@@ -394,6 +436,12 @@ a symbol containing as comma-separated
 formats")
     (show-available-fonts #f
                           "List available font names.")
+    (startup-profile #f
+                     "Print the time taken by loading every
+Scheme file and reading every init file
+before the first input file, and whether
+the Scheme files were read from bytecode.
+With job-count, init files are left out.")
     (strict-infinity-checking #f
                               "Force a crash on encountering Inf and NaN
 floating point exceptions."
@@ -407,11 +455,21 @@ explicitly.  This employs different drawing
 primitives, resulting in large PDF file size
 increases but often markedly better PDF
 previews.")
+    (svg-native-writer #f
+                       "Write SVG output with the native writer
+instead of output-svg.scm.  Repeated glyphs
+become <use> elements referring to a single
+path.")
     (tall-page-formats #f
                        "formats to use for
 tall-page output in lilypond-book. Format is
 a symbol containing as comma-separated
 formats")
+    (trace-file #f
+                "Write the time spent in each phase of the
+compilation to this file when exiting: as
+Chrome trace events if the name ends in
+`.json', as a summary table otherwise.")
     (use-paper-size-for-page #t "Set page stencil size to paper size defined in
 \\paper. If unset, the size of the page stencil will be
 defined by the extents of its contents.")
@@ -460,16 +518,34 @@ messages into errors.")
 (if (memq (ly:get-option 'backend) music-string-to-path-backends)
     (ly:set-option 'music-strings-to-paths #t))
 
+;; Whether primitive-load-path loads PATH, found as SOURCE, from
+;; bytecode on %load-compiled-path instead of reading the source.
+(define (compiled-file-current? path source)
+  (and (ly:get-option 'startup-profile)
+       ;; As in primitive-load-path, the compiled file name replaces
+       ;; the extension of the source file name.
+       (let ((compiled (search-path %load-compiled-path
+                                    (if (string-suffix? ".scm" path)
+                                        (string-drop-right path 4)
+                                        path)
+                                    %load-compiled-extensions)))
+         (and compiled
+              (>= (stat:mtime (stat compiled))
+                  (stat:mtime (stat source)))))))
+
 (define-public (ly:load x)
   (let* ((full-path (string-append "lily/" x))
          (file-name (%search-load-path full-path)))
     (ly:debug "[~A" file-name)
     (if (not file-name)
         (ly:error (G_ "cannot find: ~A") x))
-    ;; FIXME: primitive-load-path may load a compiled version of the code;
-    ;;        can this be detected and printed? If not, ly:load can be replaced
-    ;;        by primitive-load-path right away.
-    (primitive-load-path full-path)  ;; to support Guile V2 autocompile
+    ;; primitive-load-path may load a compiled version of the code;
+    ;; the startup-profile option reports which files it does not.
+    (ly:startup-profile-item
+     (if (compiled-file-current? full-path file-name) 'bytecode 'source)
+     file-name
+     (lambda ()
+       (primitive-load-path full-path)))  ;; to support Guile V2 autocompile
     ;; TODO: Any chance to use ly:debug here? Need to extend it to prevent
     ;;       a newline in this case
     (if (ly:get-option 'verbose)
@@ -560,6 +636,7 @@ determines the number of scale steps that make up an octave.  Usually the
 ;;  - Main body of files to be loaded
 (define init-scheme-files-body
   '("file-cache"
+    "score-cache"
     "define-event-classes"
     "define-music-callbacks"
     "define-music-types"
@@ -825,6 +902,14 @@ PIDs or the number of the process."
 
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 
+(define (job-file-name file-name job)
+  "Insert the number of JOB before the extension of FILE-NAME."
+  (let ((dot (string-rindex file-name #\.)))
+    (if (and dot (> dot (or (string-rindex file-name #\/) -1)))
+        (format #f "~a-~a~a"
+                (substring file-name 0 dot) job (substring file-name dot))
+        (format #f "~a-~a" file-name job))))
+
 (define-public (lilypond-main files)
   "Entry point for LilyPond."
   ;; Keep this as a fatal error: we don't want someone to
@@ -865,6 +950,10 @@ use an external tool to run LilyPond in a sandbox."))
                             (ly:get-option 'job-count)
                             1))))
     (when (>= job-count 2)
+      ;; Print the startup profile once, before the jobs inherit the
+      ;; items recorded so far.  It then leaves out the init files,
+      ;; which every job reads for itself.
+      (ly:finish-startup-profile)
       (let* ((split-todo (split-list files job-count))
              (joblist (multi-fork job-count))
              (errors '()))
@@ -874,6 +963,12 @@ use an external tool to run LilyPond in a sandbox."))
             (begin (ly:set-option
                     'log-file (format #f "~a-~a"
                                       (ly:get-option 'log-file) joblist))
+                   (if (ly:get-option 'trace-file)
+                       (ly:set-option
+                        'trace-file (job-file-name
+                                     (format #f "~a"
+                                             (ly:get-option 'trace-file))
+                                     joblist)))
                    (set! files (vector-ref split-todo joblist)))
             (begin (ly:progress "\nForking into jobs:  ~a\n" joblist)
                    (for-each
@@ -933,6 +1028,7 @@ use an external tool to run LilyPond in a sandbox."))
   ;; can spawn threads (since version 1.48.3) without leading to hangs.
   (ly:reset-all-fonts)
   (ly:parse-init "declarations-init.ly")
+  (ly:finish-startup-profile)
 
   (let* ((failed '())
          (debug-lifetimes-limit (ly:get-option 'debug-gc-object-lifetimes))
@@ -957,6 +1053,8 @@ use an external tool to run LilyPond in a sandbox."))
          (session-terminate)
          (ly:reset-options all-settings)
          (ly:reset-all-fonts)
+         (if (ly:get-option 'gc-between-files)
+             (gc))
 
          (if debug-lifetimes-limit
              (dump-zombies debug-lifetimes-limit))
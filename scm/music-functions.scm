@@ -1365,7 +1365,7 @@ post-event."
 (define-public (cue-substitute quote-music)
   "Must happen after @code{quote-substitute}."
 
-  (if (vector? (ly:music-property quote-music 'quoted-events))
+  (if (ly:quote-store? (ly:music-property quote-music 'quoted-events))
       (let* ((dir (ly:music-property quote-music 'quoted-voice-direction))
              (clef (ly:music-property quote-music 'quoted-music-clef #f))
              (main-voice (case dir ((1) 1) ((-1) 0) (else #f)))
@@ -1407,14 +1407,17 @@ post-event."
 
 (define-public ((quote-substitute quote-tab) music)
   (let* ((quoted-name (ly:music-property music 'quoted-music-name))
-         (quoted-vector (and (string? quoted-name)
-                             (hash-ref quote-tab quoted-name #f))))
+         (quoted-store (and (string? quoted-name)
+                            (hash-ref quote-tab quoted-name #f))))
 
+    ;; Entries of musicQuotes set up as vectors by user code
+    (if (vector? quoted-store)
+        (set! quoted-store (ly:make-quote-store (vector->list quoted-store))))
 
     (if (string? quoted-name)
-        (if (vector? quoted-vector)
+        (if (ly:quote-store? quoted-store)
             (begin
-              (set! (ly:music-property music 'quoted-events) quoted-vector)
+              (set! (ly:music-property music 'quoted-events) quoted-store)
               (set! (ly:music-property music 'iterator-ctor)
                     ly:quote-iterator::constructor))
             (ly:music-warning music (format #f (G_ "cannot find quoted music: `~S'") quoted-name))))
@@ -1705,7 +1708,14 @@ also get an accidental."
 
     (cons need-restore need-accidental)))
 
-(define-public ((make-accidental-rule octaveness laziness) context pitch barnum)
+(define (describe-accidental-rule! rule description)
+  "Mark @var{rule} as a standard accidental rule for the
+@code{Accidental_engraver}, which evaluates rules with a known
+@var{description} without calling them."
+  (set-procedure-property! rule 'accidental-rule description)
+  rule)
+
+(define-public (make-accidental-rule octaveness laziness)
   "Create an accidental rule that makes its decision based on the octave of
 the note and a laziness value.
 
@@ -1722,13 +1732,19 @@ is, to the end of current measure.  A positive integer means that the
 accidental lasts over that many bar lines.  @w{@code{-1}} is `forget
 immediately', that is, only look at key signature.  @code{#t} is `forever'."
 
-  (check-pitch-against-signature context pitch barnum laziness octaveness #f))
+  (describe-accidental-rule!
+   (lambda (context pitch barnum)
+     (check-pitch-against-signature context pitch barnum laziness octaveness #f))
+   (list 'signature octaveness laziness #f)))
 
-(define-public ((make-accidental-dodecaphonic-rule octaveness laziness) context pitch barnum)
+(define-public (make-accidental-dodecaphonic-rule octaveness laziness)
   "Variation on function make-accidental-rule that creates an dodecaphonic
 accidental rule."
 
-  (check-pitch-against-signature context pitch barnum laziness octaveness #t))
+  (describe-accidental-rule!
+   (lambda (context pitch barnum)
+     (check-pitch-against-signature context pitch barnum laziness octaveness #t))
+   (list 'signature octaveness laziness #t)))
 
 (define (key-entry-notename entry)
   "Return the pitch of an @var{entry} in @code{localAlterations}.
@@ -1850,6 +1866,11 @@ on the same staff line."
                             (and (equal? entry-bn barnum)
                                  (equal? entry-end-mom now)))))))))
 
+(describe-accidental-rule! neo-modern-accidental-rule '(neo-modern))
+(describe-accidental-rule! dodecaphonic-no-repeat-rule
+                           '(dodecaphonic-no-repeat))
+(describe-accidental-rule! teaching-accidental-rule '(teaching))
+
 (define-session-public accidental-styles
   ;; An alist containing specification for all accidental styles.
   ;; Each accidental style needs three entries for the context properties
@@ -29,7 +29,18 @@
   ;; spanner-state is an alist
   ;; of (SYMBOL . RESULT-INDEX), which indicates where
   ;; said spanner was started.
-  (spanner-state #:init-value '() #:accessor span-state))
+  (spanner-state #:init-value '() #:accessor span-state)
+  ;; The analysis looks at the same subsets of the events many times,
+  ;; so they are computed on first use and kept here.
+  (note-events #:init-value #f)
+  (comparable-note-events #:init-value #f)
+  (silence-events #:init-value #f))
+
+(define (cached-voice-state-slot vs slot compute)
+  (or (slot-ref vs slot)
+      (let ((val (compute vs)))
+        (slot-set! vs slot val)
+        val)))
 
 (define-method (write (x <Voice-state> ) file)
   (display (moment x) file)
@@ -52,7 +63,8 @@
 (define-method (note-events (vs <Voice-state>))
   (define (f? x)
     (ly:in-event-class? x 'note-event))
-  (filter f? (events vs)))
+  (cached-voice-state-slot vs 'note-events
+                           (lambda (vs) (filter f? (events vs)))))
 
 ;; Return a list of note events which is sorted and stripped of
 ;; properties that we do not want to prevent combining parts.
@@ -65,25 +77,29 @@
             (else (ly:duration<? (ly:event-property note1 'duration)
                                  (ly:event-property note2 'duration))))))
   ;; TODO we probably should compare articulations too
-  (sort (map (lambda (x)
-               (ly:make-stream-event
-                (ly:make-event-class 'note-event)
-                (list (cons 'duration (ly:event-property x 'duration))
-                      (cons 'pitch (ly:event-property x 'pitch)))))
-             (note-events vs))
-        note<?))
+  (define (compute vs)
+    (sort (map (lambda (x)
+                 (ly:make-stream-event
+                  (ly:make-event-class 'note-event)
+                  (list (cons 'duration (ly:event-property x 'duration))
+                        (cons 'pitch (ly:event-property x 'pitch)))))
+               (note-events vs))
+          note<?))
+  (cached-voice-state-slot vs 'comparable-note-events compute))
 
 (define-method (silence-events (vs <Voice-state>))
-  (let ((result (filter (lambda(x)
-                          (or (ly:in-event-class? x 'rest-event)
-                              (ly:in-event-class? x 'multi-measure-rest-event)))
-                        (events vs))))
-    ;; There may be skips in the same part with rests for various
-    ;; reasons.  Regard the skips only if there are no rests.
-    (if (not (pair? result))
-        (set! result (filter (lambda(x) (ly:in-event-class? x 'skip-event))
-                             (events vs))))
-    result))
+  (define (compute vs)
+    (let ((result (filter (lambda(x)
+                            (or (ly:in-event-class? x 'rest-event)
+                                (ly:in-event-class? x 'multi-measure-rest-event)))
+                          (events vs))))
+      ;; There may be skips in the same part with rests for various
+      ;; reasons.  Regard the skips only if there are no rests.
+      (if (not (pair? result))
+          (set! result (filter (lambda(x) (ly:in-event-class? x 'skip-event))
+                               (events vs))))
+      result))
+  (cached-voice-state-slot vs 'silence-events compute))
 
 (define-method (any-mmrest-events (vs <Voice-state>))
   (define (f? x)
@@ -282,59 +298,13 @@ Voice-state objects
   "Interpret @var{music} according to @var{odef}, but store all events
 in a chronological list, similar to the @code{Recording_group_engraver} in
 LilyPond version 2.8 and earlier."
-  (let*
-      ((context-list '())
-       (now-mom (ly:make-moment 0 0))
-       (global (ly:make-global-context odef))
-       (mom-listener (lambda (tev) (set! now-mom (ly:event-property tev 'moment))))
-       (new-context-listener
-        (lambda (sev)
-          (let*
-              ((child (ly:event-property sev 'context))
-               (this-moment-list (cons (ly:context-id child) '()))
-               (dummy (set! context-list (cons this-moment-list context-list)))
-               (acc '())
-               (accumulate-event-listener
-                (lambda (ev)
-                  (set! acc (cons (cons ev #t) acc))))
-               (remove-context-listener
-                (lambda (ev)
-                  "Add a final entry to record the end moment."
-                  (let ((this-moment (cons (cons
-                                            now-mom
-                                            #f ; instrumentTransposition
-                                            )
-                                           '() ; events
-                                           )))
-                    (set-cdr! this-moment-list
-                              (cons this-moment (cdr this-moment-list))))))
-               (save-acc-listener
-                (lambda (tev)
-                  (if (pair? acc)
-                      (let ((this-moment
-                             (cons (cons now-mom
-                                         (ly:context-property child 'instrumentTransposition))
-                                   ;; The accumulate-event-listener above creates
-                                   ;; the list of events in reverse order, so we
-                                   ;; have to revert it to the original order again
-                                   (reverse acc))))
-                        (set-cdr! this-moment-list
-                                  (cons this-moment (cdr this-moment-list)))
-                        (set! acc '()))))))
-            (ly:add-listener accumulate-event-listener
-                             (ly:context-event-source child) 'StreamEvent)
-            (ly:add-listener remove-context-listener
-                             (ly:context-event-source child) 'RemoveContext)
-            (ly:add-listener save-acc-listener
-                             (ly:context-event-source global) 'OneTimeStep)))))
-    (ly:add-listener new-context-listener
-                     (ly:context-events-below global) 'AnnounceNewContext)
-    (ly:add-listener mom-listener (ly:context-event-source global) 'Prepare)
+  (let* ((global (ly:make-global-context odef))
+         (recorder (ly:make-event-recorder global)))
     (ly:interpret-music-expression
      (make-non-relative-music
       (fold (lambda (x m) (x m)) music recording-group-functions))
      global)
-    context-list))
+    (ly:event-recorder-contents recorder)))
 
 (define-public (determine-split-list evl1 evl2 chord-range)
   "Event lists @var{evl1} and @var{evl2} should be ascending.
@@ -959,13 +929,35 @@ the mark when there are no spanners active.
 
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 
+(define quote-stores (make-hash-table))
+
+(define (quote-store-key mus listener)
+  "Return a key identifying the quote store of @var{mus} across the files of
+one run.  Besides its contents, it includes the input location of @var{mus},
+so that quotes of music from different places do not share their events."
+  (let ((origin (ly:music-property mus 'origin)))
+    (cons (ly:object-digest (list mus listener))
+          (and (ly:input-location? origin)
+               (ly:input-file-line-char-column origin)))))
+
 (define-public (add-quotable name mus)
   (let* ((tab (eval 'musicQuotes (current-module)))
-         (voicename (get-next-unique-voice-name))
+         (listener (ly:parser-lookup 'partCombineListener))
+         (key (quote-store-key mus listener))
+         (store (hash-ref quote-stores key)))
+    (if store
+        (hash-set! tab name store)
+        (let ((store (make-quote-store name mus listener)))
+          (if store
+              (begin
+                (hash-set! quote-stores key store)
+                (hash-set! tab name store)))))))
+
+(define (make-quote-store name mus listener)
+  (let* ((voicename (get-next-unique-voice-name))
          ;; recording-group-emulate returns an assoc list (reversed!), so
          ;; hand it a proper unique context name and extract that key:
          (ctx-spec (context-spec-music mus 'Voice voicename))
-         (listener (ly:parser-lookup 'partCombineListener))
          (context-list (reverse (recording-group-emulate ctx-spec listener)))
          (raw-voice (assoc voicename context-list))
          (quote-contents (and raw-voice (reverse! (cdr raw-voice)))))
@@ -994,5 +986,7 @@ the mark when there are no spanners active.
                     (find-non-empty (cdr current-tail)))))))
 
     (if (has-events? quote-contents)
-        (hash-set! tab name (list->vector quote-contents))
-        (ly:music-warning mus (G_ "quoted music `~a' is empty") name))))
+        (ly:make-quote-store quote-contents)
+        (begin
+          (ly:music-warning mus (G_ "quoted music `~a' is empty") name)
+          #f))))
@@ -0,0 +1,395 @@
+;;;; This file is part of LilyPond, the GNU music typesetter.
+;;;;
+;;;; Copyright (C) 2023 The LilyPond development team
+;;;;
+;;;; LilyPond is free software: you can redistribute it and/or modify
+;;;; it under the terms of the GNU General Public License as published by
+;;;; the Free Software Foundation, either version 3 of the License, or
+;;;; (at your option) any later version.
+;;;;
+;;;; LilyPond is distributed in the hope that it will be useful,
+;;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;;; GNU General Public License for more details.
+;;;;
+;;;; You should have received a copy of the GNU General Public License
+;;;; along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+
+;; Laid-out scores, kept on disk if the score-cache-dir option is set.
+;;
+;; A score is stored under a checksum of its music, its output
+;; definitions, the \paper block and the LilyPond version, as the list
+;; of its systems after line breaking.  A score read back from the
+;; cache is not interpreted or line-broken again: its systems enter
+;; page breaking like markup lines, with the line breaks and the
+;; vertical spacing inside the systems they had when they were
+;; stored.  So that the output does not depend on the state of the
+;; cache, a score with a cache key is typeset in the same way when it
+;; is not read from the cache: its systems are not stretched to fill
+;; the page, and point-and-click links are not kept.
+;;
+;; Procedures are part of the checksum only if they come from
+;; LilyPond itself (see ly:object-digest): those bound by name in the
+;; (lily) module, and those contained in the music and grob
+;; descriptions and the declarations of the initialization files,
+;; including anonymous ones like the to-relative-callback of
+;; KeyChangeEvent.  Scores using other procedures, like callbacks
+;; written in the input file, get no key and are typeset as usual.
+;;
+;; Scores that produce MIDI or contain footnotes, in-notes or labels
+;; are never cached, nor are systems with stencils that cannot be
+;; written out, like delayed stencils.
+
+(define (score-cache-dir)
+  (let ((dir (ly:get-option 'score-cache-dir)))
+    (cond ((string? dir) dir)
+          ((symbol? dir) (symbol->string dir))
+          (else #f))))
+
+;; The objects set up by the initialization files, as saved by
+;; session-save.  Their procedures are registered when the first key
+;; is computed.
+(define score-cache-init-objects #f)
+
+(define-public (score-cache-save-init-objects objects)
+  (set! score-cache-init-objects objects))
+
+(define (register-init-procedures!)
+  (if score-cache-init-objects
+      (begin
+        (ly:register-init-procedures score-cache-init-objects)
+        (set! score-cache-init-objects #f))))
+
+(define-public (score-cache-key score paper layout)
+  "Return the key under which @var{score} is cached when typeset with
+the output definitions @var{paper} and @var{layout} (the default
+@code{\\layout} block, or @code{#f}), or @code{#f} if the score cache
+is not in use or the score cannot be cached."
+  (let ((defs (ly:score-output-defs score)))
+    (and (score-cache-dir)
+         (<= (length defs) 1)
+         (every (lambda (def)
+                  (eq? 'layout (ly:output-def-lookup def 'output-def-kind)))
+                defs)
+         (or (pair? defs) layout)
+         (begin
+           (register-init-procedures!)
+           (ly:object-digest
+            (list (lilypond-version)
+                  (ly:score-music score)
+                  (if (pair? defs) (car defs) layout)
+                  paper)
+            #t)))))
+
+(define (score-cache-file-name key)
+  (format #f "~a/score-~a" (score-cache-dir) key))
+
+;; Stencils and fonts are written as vectors, which do not otherwise
+;; occur in stencil expressions or the properties of paper systems.
+(define (encode-value value)
+  (cond
+   ((or (null? value) (boolean? value) (number? value) (string? value)
+        (symbol? value) (keyword? value) (char? value))
+    value)
+   ((and (pair? value) (eq? 'grob-cause (car value))
+         (= 3 (length value)) (ly:grob? (cadr value)))
+    (encode-value (caddr value)))
+   ((list? value)
+    (map encode-value value))
+   ((pair? value)
+    (cons (encode-value (car value)) (encode-value (cdr value))))
+   ((ly:stencil? value)
+    (vector 'stencil
+            (ly:stencil-extent value X)
+            (ly:stencil-extent value Y)
+            (encode-value (ly:stencil-expr value))))
+   ((ly:font-metric? value)
+    (let ((ref (ly:font-reference value)))
+      (if ref
+          (vector 'font ref)
+          (throw 'score-cache-unserializable value))))
+   ((vector? value)
+    (list->vector (cons 'vector (map encode-value (vector->list value)))))
+   (else
+    (throw 'score-cache-unserializable value))))
+
+(define (decode-value paper value)
+  (define (decode v) (decode-value paper v))
+  (cond
+   ((list? value)
+    (map decode value))
+   ((pair? value)
+    (cons (decode (car value)) (decode (cdr value))))
+   ((vector? value)
+    (case (vector-ref value 0)
+      ((stencil)
+       (ly:make-stencil (decode (vector-ref value 3))
+                        (vector-ref value 1)
+                        (vector-ref value 2)))
+      ((font)
+       (or (ly:paper-font-from-reference paper (vector-ref value 1))
+           (throw 'score-cache-stale (vector-ref value 1))))
+      (else
+       (list->vector (map decode (cdr (vector->list value)))))))
+   (else value)))
+
+;; Mutable properties that refer to this run or are computed again on
+;; reading.
+(define score-cache-dropped-properties
+  '(system-grob vertical-skylines footnote-stencil footnotes))
+
+(define (encode-system system)
+  (list (encode-value (ly:prob-immutable-properties system))
+        (encode-value
+         (remove (lambda (entry)
+                   (memq (car entry) score-cache-dropped-properties))
+                 (ly:prob-mutable-properties system)))))
+
+(define (decode-system paper entry)
+  (let* ((system (ly:make-prob 'paper-system
+                               (decode-value paper (first entry))))
+         (stencil (ly:prob-property system 'stencil #f)))
+    (for-each (lambda (prop)
+                (ly:prob-set-property! system (car prop) (cdr prop)))
+              (decode-value paper (second entry)))
+    (if (ly:stencil? stencil)
+        (ly:prob-set-property! system 'vertical-skylines
+                               (ly:skylines-for-stencil stencil X)))
+    system))
+
+(define (make-cached-score paper entries)
+  (ly:make-prob 'cached-score '()
+                'systems (map (lambda (entry)
+                                (decode-system paper entry))
+                              entries)))
+
+(define-public (score-cache-read key paper)
+  "Return the systems of the score cached under @var{key}, with fonts
+taken from @var{paper}, as a prob of type @code{cached-score}, or
+@code{#f} if the cache has no usable entry for @var{key}."
+  (let ((file-name (score-cache-file-name key)))
+    (and (file-exists? file-name)
+         (catch #t
+           (lambda ()
+             (let ((entries (call-with-input-file file-name read
+                              #:encoding "UTF-8")))
+               (ly:debug (G_ "Reading cached score from `~a'...") file-name)
+               (make-cached-score paper entries)))
+           (lambda (key . args)
+             (ly:debug (G_ "Ignoring cached score `~a': ~a")
+                       file-name key)
+             #f)))))
+
+(define (system-cacheable? system)
+  (let ((grob (ly:prob-property system 'system-grob #f)))
+    (and (null? (ly:prob-property system 'footnotes '()))
+         (null? (ly:prob-property system 'labels '()))
+         (not (ly:prob-property system 'in-note-stencil #f))
+         (or (not grob)
+             (and (null? (ly:grob-property grob 'labels '()))
+                  (null? (ly:grob-property grob 'footnotes-after-line-breaking
+                                           '()))
+                  (not (ly:grob-property grob 'in-note-stencil #f)))))))
+
+(define (encode-score-systems systems)
+  (and (pair? systems)
+       (every system-cacheable? systems)
+       (catch 'score-cache-unserializable
+         (lambda () (map encode-system systems))
+         (lambda (key value)
+           (ly:debug (G_ "Cannot write out score: ~a") value)
+           #f))))
+
+(define (write-score-cache-file key entries)
+  (let* ((file-name (score-cache-file-name key))
+         (tmp-file (format #f "~a.~a" file-name (getpid))))
+    (catch 'system-error
+      (lambda ()
+        (if (not (file-exists? (dirname file-name)))
+            (mkdir (dirname file-name)))
+        (call-with-output-file tmp-file
+          (lambda (port) (write entries port))
+          #:encoding "UTF-8")
+        ;; See write-font-cache-file.
+        (rename-file tmp-file file-name)
+        (ly:debug (G_ "Wrote cached score to `~a'") file-name))
+      (lambda (key . args)
+        (ly:warning (G_ "cannot write score cache file `~a': ~a")
+                    file-name
+                    (apply format #f (cadr args) (caddr args)))
+        (if (file-exists? tmp-file)
+            (delete-file tmp-file))))))
+
+(define-public (score-cache-store key systems paper)
+  "Store @var{systems}, the paper systems of the score with cache key
+@var{key}, in the cache.  Return a prob of type @code{cached-score}
+holding the systems as read back from the cache, with fonts taken from
+@var{paper}, or holding @var{systems} themselves if they cannot be
+cached."
+  (let ((entries (encode-score-systems systems)))
+    (if entries
+        (begin
+          (write-score-cache-file key entries)
+          (make-cached-score paper entries))
+        (begin
+          (ly:debug (G_ "Not caching score"))
+          (ly:make-prob 'cached-score '() 'systems systems)))))
+
+;; With the score-job-count option, the scores of a book are typeset
+;; by that many forked processes.  Every worker interprets and breaks
+;; its scores into lines and writes the resulting systems to a file,
+;; in the format of the score cache; the parent reads them back and
+;; only runs page breaking.  As with cached scores, the spacing inside
+;; the systems is not adjusted to the page and point-and-click links
+;; are dropped, so the output differs from that of a single process.
+;; Scores that cannot be written out are typeset again by the parent.
+;;
+;; The workers are forked after the fonts have been set up, which
+;; -djob-count avoids since Pango may have started threads.  Each
+;; worker therefore resets the fonts before typesetting.
+;;
+;; The diagnostics of a worker are kept per score and printed by the
+;; parent only for the scores it takes over, so that they do not
+;; appear twice for scores typeset again.  Expected warnings
+;; (ly:expect-warning) are registered in the parent and could not be
+;; matched in a worker, so while any are pending, all scores are left
+;; to the parent.
+
+(define (score-worker-candidate? score paper layout)
+  (and (ly:score? score)
+       (not (ly:score-error? score))
+       (let ((defs (ly:score-output-defs score)))
+         (and (<= (length defs) 1)
+              (every (lambda (def)
+                       (eq? 'layout
+                            (ly:output-def-lookup def 'output-def-kind)))
+                     defs)
+              (or (pair? defs) layout)))
+       ;; Do not typeset scores that the parent reads from the cache.
+       (let ((key (score-cache-key score paper layout)))
+         (not (and key (file-exists? (score-cache-file-name key)))))))
+
+(define (run-score-worker file-name jobs paper layout)
+  "Typeset JOBS, a list of (INDEX . SCORE), and write a list of (INDEX
+LOG . ENTRIES) to FILE-NAME, with the encoded systems and the
+diagnostics of each score.  Does not return."
+  ;; Fatal errors must not run the exit handlers or flush the output
+  ;; buffers inherited from the parent.
+  (ly:exit-immediately-on-error)
+  ;; The parent has set up Pango, which may have started threads that
+  ;; do not exist in this process; do not use its font map (see
+  ;; lilypond-all).
+  (ly:reset-all-fonts)
+  (let* ((log-file (string-append file-name ".log"))
+         (status
+          (catch #t
+            (lambda ()
+              (let ((results
+                     (filter-map
+                      (lambda (job)
+                        (ly:stderr-redirect log-file "w")
+                        (let* ((systems (ly:score-paper-systems
+                                         (cdr job) paper layout))
+                               (entries (and systems
+                                             (encode-score-systems systems))))
+                          (force-output (current-error-port))
+                          (and entries
+                               (cons* (car job)
+                                      (call-with-input-file log-file
+                                        get-string-all
+                                        #:encoding "UTF-8")
+                                      entries))))
+                      jobs)))
+                (call-with-output-file file-name
+                  (lambda (port) (write results port))
+                  #:encoding "UTF-8")
+                0))
+            (lambda (key . args)
+              (ly:debug (G_ "score worker failed: ~a ~a") key args)
+              1))))
+    (force-output (current-error-port))
+    (primitive-_exit status)))
+
+(define-public (typeset-scores-in-workers scores paper layout)
+  "Return a list with an element for each of @var{scores}: a prob of
+type @code{cached-score} holding its systems if a worker process
+typeset it, or @code{#f} if it is left to the caller.  @var{paper} and
+@var{layout} are the output definitions of the book."
+  (let* ((job-count (ly:get-option 'score-job-count))
+         (candidates
+          (if (and (integer? job-count) (>= job-count 2)
+                   (null? (ly:expected-warnings)))
+              (filter-map (lambda (score index)
+                            (and (score-worker-candidate? score paper layout)
+                                 (cons index score)))
+                          scores (iota (length scores)))
+              '()))
+         (count (min (if (integer? job-count) job-count 1)
+                     (length candidates))))
+    (if (< count 2)
+        (map (const #f) scores)
+        (let* ((files (map (lambda (job)
+                             (let* ((port (make-tmpfile #f))
+                                    (name (port-filename port)))
+                               (close-port port)
+                               name))
+                           (iota count)))
+               ;; Distribute the scores round-robin, since long and
+               ;; short scores tend to be grouped.
+               (jobs (map (lambda (job)
+                            (filter-map (lambda (candidate k)
+                                          (and (= job (modulo k count))
+                                               candidate))
+                                        candidates
+                                        (iota (length candidates))))
+                          (iota count)))
+               (pids (map (lambda (file-name job-list)
+                            ;; Do not leave buffered output for the
+                            ;; worker to write again.
+                            (flush-all-ports)
+                            (let ((pid (primitive-fork)))
+                              (if (= pid 0)
+                                  (run-score-worker file-name job-list
+                                                    paper layout)
+                                  pid)))
+                          files jobs))
+               (results
+                (append-map
+                 (lambda (pid file-name)
+                   (let ((status (cdr (waitpid pid))))
+                     (if (and (status:exit-val status)
+                              (zero? (status:exit-val status)))
+                         (catch #t
+                           (lambda ()
+                             (call-with-input-file file-name read
+                               #:encoding "UTF-8"))
+                           (lambda (key . args)
+                             (ly:warning
+                              (G_ "cannot read results of score worker: ~a")
+                              key)
+                             '()))
+                         '())))
+                 pids files)))
+          (for-each (lambda (file-name)
+                      (for-each (lambda (name)
+                                  (if (file-exists? name)
+                                      (delete-file name)))
+                                (list file-name
+                                      (string-append file-name ".log"))))
+                    files)
+          (ly:debug (G_ "Typeset ~a of ~a scores in ~a workers")
+                    (length results) (length candidates) count)
+          (map (lambda (index)
+                 (let* ((result (assv-ref results index))
+                        (score (and result
+                                    (catch #t
+                                      (lambda ()
+                                        (make-cached-score paper
+                                                           (cdr result)))
+                                      (lambda (key . args) #f)))))
+                   (if score
+                       (begin
+                         (display (car result) (current-error-port))
+                         (force-output (current-error-port))))
+                   score))
+               (iota (length scores)))))))
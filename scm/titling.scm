@@ -43,6 +43,110 @@ interpreting a markup in the context of these headers."
 
 ;;;;;;;;;;;;;;;;;;
 
+;;; Header and footer templates
+;;;
+;;; Headers and footers are interpreted once per page, but they
+;;; typically differ between pages only in a few fragments like the
+;;; page number.  We therefore interpret them as templates: every
+;;; markup command in a header or footer is wrapped into a fragment
+;;; that remembers its stencil together with the page-dependent
+;;; properties (the @code{page:} alist) actually read while
+;;; interpreting it.  On later pages, a fragment whose inputs are
+;;; unchanged reuses its stencil, and only the variable fragments and
+;;; their enclosing commands are interpreted again.
+
+;; Fragment stencils are kept for this many distinct sets of
+;; page-dependent values per fragment.
+(define headfoot-fragment-cache-size 16)
+
+;; The state of the header or footer currently being interpreted: a
+;; pair of the page alist and the fragment cache of the paper book.
+(define headfoot-template-state (make-parameter #f))
+
+(define (split-at-alist props alist)
+  "Split alist chain @var{props} at @var{alist}.  Return a pair of the
+alists preceding @var{alist} and the alists following it, or @code{#f}
+if @var{alist} is not part of @var{props}."
+  (let loop ((rest props) (prefix '()))
+    (cond ((not (pair? rest)) #f)
+          ((eq? (car rest) alist) (cons (reverse! prefix) (cdr rest)))
+          (else (loop (cdr rest) (cons (car rest) prefix))))))
+
+(define (headfoot-fragment layout props mkup)
+  (let* ((state (headfoot-template-state))
+         (page-alist (and state (car state)))
+         (split (and state (split-at-alist props page-alist))))
+    (if (not split)
+        (interpret-markup layout props mkup)
+        (let* ((cache (cdr state))
+               (entries (hashq-ref cache mkup '()))
+               (hit (find
+                     (lambda (entry)
+                       (and (eq? (vector-ref entry 0) layout)
+                            (eq? (vector-ref entry 2) (cdr split))
+                            (equal? (vector-ref entry 1) (car split))
+                            (every (lambda (kv)
+                                     (let ((handle (assq (car kv) page-alist)))
+                                       (and handle
+                                            (equal? (cdr handle) (cdr kv)))))
+                                   (vector-ref entry 3))))
+                     entries)))
+          (if hit
+              (let ((keys (map car (vector-ref hit 3))))
+                ;; Enclosing fragments depend on the same properties.
+                (ly:chain-assoc-watch
+                 page-alist
+                 (append keys (ly:chain-assoc-watch page-alist '())))
+                (vector-ref hit 4))
+              (let* ((outer (ly:chain-assoc-watch page-alist '()))
+                     (stencil (interpret-markup layout props mkup))
+                     (keys (delete-duplicates
+                            (ly:chain-assoc-watch page-alist '())
+                            eq?))
+                     (entry (vector layout (car split) (cdr split)
+                                    (map (lambda (key)
+                                           (assq key page-alist))
+                                         keys)
+                                    stencil)))
+                (ly:chain-assoc-watch page-alist (append keys outer))
+                (hashq-set! cache mkup
+                            (cons entry
+                                  (list-head entries
+                                             (min (length entries)
+                                                  (1- headfoot-fragment-cache-size)))))
+                stencil))))))
+
+(set! (markup-command-signature headfoot-fragment) (list markup?))
+
+(define headfoot-templates (make-weak-key-hash-table))
+
+(define (markup->headfoot-template mkup)
+  "Return @var{mkup} with all markup commands wrapped into header and
+footer fragments."
+  (define (wrap-list lst)
+    (if (markup-command-list? lst)
+        lst
+        (map (lambda (m) (if (markup-command-list? m) m (wrap m))) lst)))
+  (define (wrap m)
+    (if (and (pair? m) (markup-function? (car m)))
+        (list headfoot-fragment
+              (cons (car m)
+                    (map (lambda (pred arg)
+                           (cond ((eq? pred markup?) (wrap arg))
+                                 ((eq? pred markup-list?) (wrap-list arg))
+                                 (else arg)))
+                         (markup-command-signature (car m))
+                         (cdr m))))
+        m))
+  (or (hashq-ref headfoot-templates mkup)
+      (let ((template (wrap mkup)))
+        (hashq-set! headfoot-templates mkup template)
+        template)))
+
+;; Per paper book, the fragment cache and the page-independent part
+;; of the property chain.
+(define headfoot-book-state (make-weak-key-hash-table))
+
 (define-public ((marked-up-headfoot what-odd what-even) page)
   "Read variables @var{what-odd} and @var{what-even} from the page's
 layout.  Interpret either of them as markup, with properties
@@ -69,16 +173,34 @@ reflecting the variables in the page's layout and header modules."
                (tagline (ly:modules-lookup scopes
                                            'tagline
                                            (ly:output-def-lookup layout 'tagline)))
-               (basic-props (layout-extract-page-properties layout))
-               (header-props (headers-property-alist-chain scopes))
+               (book-state
+                (or (hashq-ref headfoot-book-state paper-book)
+                    (let ((state
+                           (cons (make-hash-table)
+                                 (append (headers-property-alist-chain scopes)
+                                         (layout-extract-page-properties layout)))))
+                      (hashq-set! headfoot-book-state paper-book state)
+                      state)))
                (extra-properties
                 `((page:is-last-bookpart . ,is-last-bookpart)
                   (page:is-bookpart-last-page . ,is-bookpart-last-page)
                   (page:page-number . ,page-number)
                   (page:page-number-string . ,(number-format number-type page-number))
+                  (page:on-first-page
+                   . ,(= page-number (book-first-page layout '())))
+                  (page:on-first-page-of-part
+                   . ,(= page-number
+                         (ly:output-def-lookup layout 'first-page-number)))
                   (header:tagline . ,tagline)))
-               (props (cons extra-properties (append header-props basic-props))))
-          (interpret-markup layout props header-mkup))
+               (props (cons extra-properties (cdr book-state))))
+          (dynamic-wind
+            (lambda () (ly:chain-assoc-watch extra-properties '()))
+            (lambda ()
+              (parameterize ((headfoot-template-state
+                              (cons extra-properties (car book-state))))
+                (interpret-markup layout props
+                                  (markup->headfoot-template header-mkup))))
+            (lambda () (ly:chain-assoc-watch #f '()))))
         empty-stencil)))
 
 (define-public ((marked-up-title what) layout scopes)
@@ -0,0 +1,162 @@
+# bench-score.py
+# -*- coding: utf-8 -*-
+#
+# This file is part of LilyPond, the GNU music typesetter.
+#
+# Copyright (C) 2023 The LilyPond development team
+#
+# LilyPond is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# LilyPond is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Generate a synthetic score for benchmarking.
+
+The score has STAVES staves of BARS bars of 4/4.  The density options
+(between 0 and 1) give the fraction of bars that are written in beamed
+eighth notes, are covered by a slur, use chords instead of single
+notes, or start with a markup, and the fraction of staves that get
+lyrics.  The output only depends on the options and the random seed, so
+that timings of different LilyPond versions can be compared.
+"""
+
+import argparse
+import random
+import sys
+
+VERSION = '2.25.4'
+
+# Absolute pitches of the diatonic scale from c' to a''.
+TREBLE_PITCHES = ["c'", "d'", "e'", "f'", "g'", "a'", "b'",
+                  "c''", "d''", "e''", "f''", "g''", "a''"]
+# From e, to c'.
+BASS_PITCHES = ["e,", "f,", "g,", "a,", "b,",
+                "c", "d", "e", "f", "g", "a", "b", "c'"]
+
+MARKUPS = [r'\italic "dolce"', r'\bold "f"', r'\italic "rit."',
+           r'\line { \italic "poco" "a poco" }']
+SYLLABLES = ['la', 'li', 'lo', 'lu', 'ne', 'mi', 'ta', 'so', 'ra', 'do']
+
+
+def make_chord(rng, pitches, index):
+    top = min(index + rng.choice([2, 4]), len(pitches) - 1)
+    notes = [pitches[index], pitches[(index + top) // 2], pitches[top]]
+    return '<' + ' '.join(notes) + '>'
+
+
+def make_bar(rng, pitches, options):
+    """Return the notes of one bar and the number of syllables needed."""
+    eighths = rng.random() < options.beams
+    count = 8 if eighths else 4
+    duration = '8' if eighths else '4'
+    chords = rng.random() < options.chords
+
+    index = rng.randrange(len(pitches))
+    notes = []
+    for _ in range(count):
+        index = max(0, min(len(pitches) - 1, index + rng.randint(-2, 2)))
+        note = (make_chord(rng, pitches, index) if chords
+                else pitches[index])
+        notes.append(note + (duration if not notes else ''))
+
+    if eighths:
+        for i in range(0, count, 4):
+            notes[i] += '['
+            notes[i + 3] += ']'
+    if rng.random() < options.markups:
+        notes[0] += '^\\markup { %s }' % rng.choice(MARKUPS)
+    if rng.random() < options.slurs:
+        notes[0] += '('
+        notes[-1] += ')'
+    return ' '.join(notes), count
+
+
+def make_staff(rng, number, options):
+    bass = number % 2 == 1 and options.staves > 1
+    pitches = BASS_PITCHES if bass else TREBLE_PITCHES
+    bars = []
+    syllables = 0
+    for _ in range(options.bars):
+        bar, count = make_bar(rng, pitches, options)
+        bars.append('    ' + bar + ' |')
+        syllables += count
+
+    music = '\n'.join(bars)
+    text = ''
+    if rng.random() < options.lyrics:
+        words = [rng.choice(SYLLABLES) for _ in range(syllables)]
+        lines = [' '.join(words[i:i + 16])
+                 for i in range(0, len(words), 16)]
+        text = ('  \\addlyrics {\n    \\set ignoreMelismata = ##t\n'
+                + '\n'.join('    ' + line for line in lines) + '\n  }\n')
+    return ('  \\new Staff \\with { instrumentName = "%d" } {\n'
+            '    \\clef %s\n    \\time 4/4\n%s\n  }\n%s'
+            % (number + 1, 'bass' if bass else 'treble', music, text))
+
+
+def generate(options):
+    rng = random.Random(options.seed)
+    staves = ''.join(make_staff(rng, n, options)
+                     for n in range(options.staves))
+    return ('\\version "%s"\n\n'
+            '%% Synthetic benchmark score, generated by bench-score.py\n'
+            '%% with %s\n\n'
+            '\\header { tagline = ##f }\n\n'
+            '\\score {\n  <<\n%s  >>\n  \\layout { }\n}\n'
+            % (VERSION, describe(options), staves))
+
+
+def describe(options):
+    return ('staves=%d bars=%d beams=%g slurs=%g lyrics=%g chords=%g '
+            'markups=%g seed=%d'
+            % (options.staves, options.bars, options.beams, options.slurs,
+               options.lyrics, options.chords, options.markups, options.seed))
+
+
+def density(s):
+    value = float(s)
+    if not 0 <= value <= 1:
+        raise argparse.ArgumentTypeError('density must be between 0 and 1')
+    return value
+
+
+def add_options(parser):
+    parser.add_argument('--staves', type=int, default=4)
+    parser.add_argument('--bars', type=int, default=64)
+    parser.add_argument('--beams', type=density, default=0.5,
+                        help='fraction of bars in beamed eighth notes')
+    parser.add_argument('--slurs', type=density, default=0.3,
+                        help='fraction of bars under a slur')
+    parser.add_argument('--lyrics', type=density, default=0.25,
+                        help='fraction of staves with lyrics')
+    parser.add_argument('--chords', type=density, default=0.2,
+                        help='fraction of bars in chords')
+    parser.add_argument('--markups', type=density, default=0.1,
+                        help='fraction of bars starting with a markup')
+    parser.add_argument('--seed', type=int, default=1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    add_options(parser)
+    parser.add_argument('-o', '--output', help='output file (default: stdout)')
+    options = parser.parse_args()
+
+    score = generate(options)
+    if options.output:
+        with open(options.output, 'w', encoding='utf-8') as f:
+            f.write(score)
+    else:
+        sys.stdout.write(score)
+
+
+if __name__ == '__main__':
+    main()
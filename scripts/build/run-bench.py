@@ -0,0 +1,227 @@
+# run-bench.py
+# -*- coding: utf-8 -*-
+#
+# This file is part of LilyPond, the GNU music typesetter.
+#
+# Copyright (C) 2023 The LilyPond development team
+#
+# LilyPond is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# LilyPond is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Run the LilyPond benchmarks and write the results as JSON.
+
+Every benchmark score is generated by bench-score.py and compiled
+REPEAT times with -dtrace-file; for each phase of the compilation the
+fastest run is reported.  One more run with -dprofile-callbacks gives
+the time spent in the grob callbacks, summed into components (beam
+quanting, skylines, ...).  The peak memory use is measured for every
+setting in MEMORY_MODES.  The output of the flower micro-benchmarks is
+included if the executable is given.
+"""
+
+import argparse
+import datetime
+import importlib.util
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+spec = importlib.util.spec_from_file_location(
+    'bench_score', os.path.join(os.path.dirname(__file__), 'bench-score.py'))
+bench_score = importlib.util.module_from_spec(spec)
+spec.loader.exec_module(bench_score)
+
+# name: bench-score.py options
+SCORES = {
+    'small': {'staves': 2, 'bars': 32},
+    'orchestral': {'staves': 16, 'bars': 64},
+    'long': {'staves': 2, 'bars': 512},
+    'beams': {'staves': 4, 'bars': 128, 'beams': 1, 'chords': 0.5,
+              'slurs': 0},
+    'slurs-lyrics': {'staves': 4, 'bars': 128, 'slurs': 1, 'lyrics': 1,
+                     'markups': 0.5},
+}
+
+# name: extra LilyPond arguments; peak memory use is compared between these.
+MEMORY_MODES = {
+    'default': [],
+    'music-copy-on-write': ['-dmusic-copy-on-write'],
+}
+
+# Grob properties whose callbacks are attributed to a component.
+COMPONENTS = {
+    'beam-scoring': ['quantized-positions'],
+    'skylines': ['vertical-skylines', 'horizontal-skylines'],
+    'slur-scoring': ['control-points'],
+    'stencils': ['stencil'],
+}
+
+
+def score_options(name, scale):
+    parser = argparse.ArgumentParser()
+    bench_score.add_options(parser)
+    options = parser.parse_args([])
+    for key, value in SCORES[name].items():
+        setattr(options, key, value)
+    options.bars = max(1, int(options.bars * scale))
+    return options
+
+
+def run_lilypond(lilypond, ly_file, extra_args):
+    """Return the wall time, the standard error output and the peak
+    resident set size in kilobytes of a LilyPond run."""
+    args = [lilypond, '--loglevel=ERROR', '-dno-point-and-click',
+            '-o', os.path.splitext(ly_file)[0]] + extra_args + [ly_file]
+    start = time.monotonic()
+    with tempfile.TemporaryFile(mode='w+', encoding='utf-8') as err:
+        proc = subprocess.Popen(args, stderr=err)
+        _, status, usage = os.wait4(proc.pid, 0)
+        elapsed = time.monotonic() - start
+        err.seek(0)
+        stderr = err.read()
+    if status:
+        sys.stderr.write(stderr)
+        sys.exit('%s failed on %s' % (lilypond, ly_file))
+    return elapsed, stderr, usage.ru_maxrss
+
+
+def read_phases(trace_file):
+    """Sum the durations of the spans in TRACE_FILE per phase, in seconds."""
+    with open(trace_file, encoding='utf-8') as f:
+        events = json.load(f)['traceEvents']
+    phases = {}
+    for event in events:
+        phases[event['name']] = (phases.get(event['name'], 0)
+                                 + event['dur'] * 1e-6)
+    return phases
+
+
+def parse_callback_profile(stderr):
+    """Parse the table printed at exit by -dprofile-callbacks."""
+    rows = []
+    in_table = False
+    for line in stderr.splitlines():
+        fields = line.split(None, 5)
+        if fields[:2] == ['grob', 'property']:
+            in_table = True
+            continue
+        if not in_table or len(fields) < 5:
+            continue
+        rows.append({'grob': fields[0],
+                     'property': fields[1],
+                     'count': int(fields[2]),
+                     'inclusive': float(fields[3]),
+                     'exclusive': float(fields[4]),
+                     'procedure': fields[5] if len(fields) > 5 else ''})
+    return rows
+
+
+def bench_score_file(name, options, args):
+    ly_file = os.path.join(args.work_dir, name + '.ly')
+    with open(ly_file, 'w', encoding='utf-8') as f:
+        f.write(bench_score.generate(options))
+
+    trace_file = os.path.join(args.work_dir, name + '-trace.json')
+    best_wall = None
+    best_phases = {}
+    for _ in range(args.repeat):
+        wall, _, _ = run_lilypond(args.lilypond, ly_file,
+                                  ['-dtrace-file=' + trace_file])
+        best_wall = wall if best_wall is None else min(best_wall, wall)
+        for phase, seconds in read_phases(trace_file).items():
+            best_phases[phase] = min(best_phases.get(phase, seconds),
+                                     seconds)
+
+    _, stderr, _ = run_lilypond(args.lilypond, ly_file,
+                                ['-dprofile-callbacks'])
+    callbacks = parse_callback_profile(stderr)
+    components = {
+        component: sum(row['exclusive'] for row in callbacks
+                       if row['property'] in properties)
+        for component, properties in COMPONENTS.items()}
+    components['line-breaking'] = best_phases.get('line-breaking', 0)
+
+    memory = {mode: run_lilypond(args.lilypond, ly_file, extra)[2]
+              for mode, extra in MEMORY_MODES.items()}
+
+    return {'name': name,
+            'options': bench_score.describe(options),
+            'wall': best_wall,
+            'phases': best_phases,
+            'components': components,
+            'max_rss_kb': memory,
+            'callbacks': callbacks[:args.top_callbacks]}
+
+
+def run_micro_benchmarks(executable):
+    proc = subprocess.run([executable], stdout=subprocess.PIPE,
+                          universal_newlines=True, check=True)
+    return [json.loads(line) for line in proc.stdout.splitlines() if line]
+
+
+def lilypond_version(lilypond):
+    proc = subprocess.run([lilypond, '--version'], stdout=subprocess.PIPE,
+                          universal_newlines=True, check=True)
+    return proc.stdout.splitlines()[0]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--lilypond', default='lilypond',
+                        help='LilyPond executable')
+    parser.add_argument('--flower-bench',
+                        help='micro-benchmark executable to run')
+    parser.add_argument('--output', default='bench-results.json',
+                        help='JSON file to write')
+    parser.add_argument('--work-dir', default='bench',
+                        help='directory for scores and traces')
+    parser.add_argument('--scores', default=','.join(SCORES),
+                        help='comma-separated benchmark scores to run '
+                        '(default: all of %(default)s)')
+    parser.add_argument('--scale', type=float, default=1.0,
+                        help='multiply the number of bars by this')
+    parser.add_argument('--repeat', type=int, default=3,
+                        help='compile every score this many times')
+    parser.add_argument('--top-callbacks', type=int, default=20,
+                        help='number of callbacks to include per score')
+    args = parser.parse_args()
+
+    os.makedirs(args.work_dir, exist_ok=True)
+    args.work_dir = os.path.abspath(args.work_dir)
+
+    results = {'date': datetime.datetime.now().isoformat(timespec='seconds'),
+               'lilypond': lilypond_version(args.lilypond),
+               'scores': [],
+               'micro': []}
+    for name in args.scores.split(','):
+        if name not in SCORES:
+            sys.exit('unknown benchmark score: %s' % name)
+        sys.stderr.write('benchmarking %s\n' % name)
+        results['scores'].append(
+            bench_score_file(name, score_options(name, args.scale), args))
+
+    if args.flower_bench:
+        sys.stderr.write('running micro-benchmarks\n')
+        results['micro'] = run_micro_benchmarks(args.flower_bench)
+
+    with open(args.output, 'w', encoding='utf-8') as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+        f.write('\n')
+    sys.stderr.write('results written to %s\n' % args.output)
+
+
+if __name__ == '__main__':
+    main()